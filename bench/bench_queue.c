@@ -0,0 +1,327 @@
+/*
+ * bench_queue.c
+ *
+ * Throughput and latency benchmarks for QUEUE_DEFINE / QUEUE_DEFINE_PADDED
+ * and their run-time sized (QUEUE_DEFINE_RUNTIME{,_PADDED}) and out-of-line
+ * (QUEUE_DEFINE_OUTLINE) counterparts.
+ *
+ * Built once per full-policy (QUEUE_OVERWRITE_ON_FULL=0/1). Every result is
+ * printed as one JSON object per line:
+ *
+ *   {"bench":"spsc","mode":"fail","layout":"padded","elem_size":64,
+ *    "capacity":1024,"cores":"0,1","ops":200000,"ops_per_sec":1.2e+08}
+ *
+ * Benchmarks:
+ * - st:   single thread, enqueue+dequeue pairs (ops = items)
+ * - spsc: producer and consumer on the pinned core pair (ops = items)
+ * - rtt:  ping-pong over two queues between the core pair; reports round-trip
+ *         p50/p99/p99.9 in nanoseconds
+ *
+ * Options: --iters N (items per run), --cores A,B (core pair, -1 = unpinned).
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if QUEUE_OVERWRITE_ON_FULL
+/* Overwrite mode needs critical sections between threads. */
+static atomic_flag bench_lock = ATOMIC_FLAG_INIT;
+#define QUEUE_ENTER_CRITICAL()                                                 \
+        do {                                                                   \
+                while (atomic_flag_test_and_set_explicit(                      \
+                    &bench_lock, memory_order_acquire)) {                      \
+                }                                                              \
+        } while (0)
+#define QUEUE_EXIT_CRITICAL()                                                  \
+        atomic_flag_clear_explicit(&bench_lock, memory_order_release)
+#define BENCH_MODE "overwrite"
+#else
+#define BENCH_MODE "fail"
+#endif
+
+#include "queue.h"
+
+#define BENCH_RTT_SAMPLES 20000U
+#define BENCH_SPIN_LIMIT  1024U
+
+static size_t bench_iters = 1000000U;
+static int bench_cores[2] = {0, 1};
+
+static uint64_t
+bench_now_ns(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/* Spin briefly, then yield so oversubscribed machines still make progress. */
+static void
+bench_pause(unsigned *spins)
+{
+        if (++*spins >= BENCH_SPIN_LIMIT) {
+                *spins = 0U;
+                sched_yield();
+        }
+}
+
+static void
+bench_pin(int core)
+{
+        if (core < 0) {
+                return;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static int
+bench_cmp_u64(const void *a, const void *b)
+{
+        const uint64_t x = *(const uint64_t *)a;
+        const uint64_t y = *(const uint64_t *)b;
+        return (x > y) - (x < y);
+}
+
+static void
+bench_report(const char *bench, const char *layout, size_t elem_size,
+             size_t capacity, size_t ops, uint64_t ns)
+{
+        printf("{\"bench\":\"%s\",\"mode\":\"%s\",\"layout\":\"%s\","
+               "\"elem_size\":%zu,\"capacity\":%zu,\"cores\":\"%d,%d\","
+               "\"ops\":%zu,\"ops_per_sec\":%.6g}\n",
+               bench, BENCH_MODE, layout, elem_size, capacity, bench_cores[0],
+               bench_cores[1], ops, (double)ops * 1e9 / (double)ns);
+}
+
+static void
+bench_report_rtt(const char *layout, size_t elem_size, size_t capacity,
+                 uint64_t *samples, size_t n)
+{
+        qsort(samples, n, sizeof(samples[0]), bench_cmp_u64);
+        printf("{\"bench\":\"rtt\",\"mode\":\"%s\",\"layout\":\"%s\","
+               "\"elem_size\":%zu,\"capacity\":%zu,\"cores\":\"%d,%d\","
+               "\"samples\":%zu,\"p50_ns\":%llu,\"p99_ns\":%llu,"
+               "\"p999_ns\":%llu}\n",
+               BENCH_MODE, layout, elem_size, capacity, bench_cores[0],
+               bench_cores[1], n, (unsigned long long)samples[n / 2U],
+               (unsigned long long)samples[(n * 99U) / 100U],
+               (unsigned long long)samples[(n * 999U) / 1000U]);
+}
+
+/*
+ * Adapts QUEUE_DEFINE_RUNTIME{,_PADDED} to the fixed-capacity API used by
+ * the benchmarks: each queue embeds its own storage and init passes it in.
+ */
+#define BENCH__RUNTIME_ADAPTER(DEF, name, type, cap)                           \
+        DEF(name##_rt, type)                                                   \
+        typedef struct {                                                       \
+                name##_rt_t q;                                                 \
+                type storage[QUEUE_RUNTIME_SLOTS(cap)];                        \
+        } name##_t;                                                            \
+        static inline void name##_init(name##_t *q)                            \
+        {                                                                      \
+                (void)name##_rt_init(&q->q, q->storage,                        \
+                                     QUEUE_RUNTIME_SLOTS(cap));                \
+        }                                                                      \
+        static inline queue_status_t name##_enqueue(name##_t *q,               \
+                                                    const type *item)          \
+        {                                                                      \
+                return name##_rt_enqueue(&q->q, item);                         \
+        }                                                                      \
+        static inline queue_status_t name##_dequeue(name##_t *q, type *out)    \
+        {                                                                      \
+                return name##_rt_dequeue(&q->q, out);                          \
+        }
+
+#define BENCH_QUEUE_RUNTIME(name, type, cap)                                   \
+        BENCH__RUNTIME_ADAPTER(QUEUE_DEFINE_RUNTIME, name, type, cap)
+#define BENCH_QUEUE_RUNTIME_PADDED(name, type, cap)                            \
+        BENCH__RUNTIME_ADAPTER(QUEUE_DEFINE_RUNTIME_PADDED, name, type, cap)
+
+/*
+ * BENCH__DEFINE_IMPL(DEF, name, layout, size, cap)
+ *
+ * Instantiates a queue with `DEF` (QUEUE_DEFINE, QUEUE_DEFINE_PADDED,
+ * QUEUE_DEFINE_OUTLINE or a BENCH_QUEUE_RUNTIME* adapter) for `size`-byte
+ * elements and `cap` slots, plus `name()` running all benchmarks on it.
+ * `layout` is the label used in the output.
+ */
+#define BENCH__DEFINE_IMPL(DEF, name, layout, size, cap)                       \
+        typedef union {                                                        \
+                uint64_t seq;                                                  \
+                uint8_t bytes[size];                                           \
+        } name##_elem_t;                                                       \
+        DEF(name##_q, name##_elem_t, cap)                                      \
+                                                                               \
+        static name##_q_t name##_qa, name##_qb;                                \
+        static atomic_bool name##_done;                                        \
+                                                                               \
+        static void *name##_consumer(void *arg)                                \
+        {                                                                      \
+                (void)arg;                                                     \
+                bench_pin(bench_cores[1]);                                     \
+                name##_elem_t e;                                               \
+                unsigned spins = 0U;                                           \
+                for (;;) {                                                     \
+                        const bool done = atomic_load(&name##_done);           \
+                        if (name##_q_dequeue(&name##_qa, &e) ==                \
+                            QUEUE_STATUS_OK) {                                 \
+                                if (e.seq == (uint64_t)bench_iters - 1U) {     \
+                                        break;                                 \
+                                }                                              \
+                        } else if (done) {                                     \
+                                break;                                         \
+                        } else {                                               \
+                                bench_pause(&spins);                           \
+                        }                                                      \
+                }                                                              \
+                return NULL;                                                   \
+        }                                                                      \
+                                                                               \
+        static void *name##_echo(void *arg)                                    \
+        {                                                                      \
+                (void)arg;                                                     \
+                bench_pin(bench_cores[1]);                                     \
+                name##_elem_t e;                                               \
+                unsigned spins = 0U;                                           \
+                for (size_t i = 0; i < BENCH_RTT_SAMPLES; i++) {               \
+                        while (name##_q_dequeue(&name##_qa, &e) !=             \
+                               QUEUE_STATUS_OK) {                              \
+                                bench_pause(&spins);                           \
+                        }                                                      \
+                        (void)name##_q_enqueue(&name##_qb, &e);                \
+                }                                                              \
+                return NULL;                                                   \
+        }                                                                      \
+                                                                               \
+        static void name(void)                                                 \
+        {                                                                      \
+                name##_q_t *qa = &name##_qa;                                   \
+                name##_q_t *qb = &name##_qb;                                   \
+                name##_elem_t e;                                               \
+                memset(&e, 0, sizeof(e));                                      \
+                                                                               \
+                /* st: single thread */                                        \
+                bench_pin(bench_cores[0]);                                     \
+                name##_q_init(qa);                                             \
+                uint64_t t0 = bench_now_ns();                                  \
+                for (size_t i = 0; i < bench_iters; i++) {                     \
+                        e.seq = i;                                             \
+                        (void)name##_q_enqueue(qa, &e);                        \
+                        (void)name##_q_dequeue(qa, &e);                        \
+                }                                                              \
+                bench_report("st", layout, (size), (cap), bench_iters,         \
+                             bench_now_ns() - t0);                             \
+                                                                               \
+                /* spsc: cross-core throughput */                              \
+                name##_q_init(qa);                                             \
+                atomic_store(&name##_done, false);                             \
+                pthread_t th;                                                  \
+                t0 = bench_now_ns();                                           \
+                pthread_create(&th, NULL, name##_consumer, NULL);              \
+                unsigned spins = 0U;                                           \
+                for (size_t i = 0; i < bench_iters; i++) {                     \
+                        e.seq = i;                                             \
+                        while (name##_q_enqueue(qa, &e) ==                     \
+                               QUEUE_STATUS_FULL) {                            \
+                                bench_pause(&spins);                           \
+                        }                                                      \
+                }                                                              \
+                atomic_store(&name##_done, true);                              \
+                pthread_join(th, NULL);                                        \
+                bench_report("spsc", layout, (size), (cap), bench_iters,       \
+                             bench_now_ns() - t0);                             \
+                                                                               \
+                /* rtt: ping-pong latency */                                   \
+                static uint64_t samples[BENCH_RTT_SAMPLES];                    \
+                name##_q_init(qa);                                             \
+                name##_q_init(qb);                                             \
+                pthread_create(&th, NULL, name##_echo, NULL);                  \
+                for (size_t i = 0; i < BENCH_RTT_SAMPLES; i++) {               \
+                        e.seq = i;                                             \
+                        t0 = bench_now_ns();                                   \
+                        (void)name##_q_enqueue(qa, &e);                        \
+                        while (name##_q_dequeue(qb, &e) != QUEUE_STATUS_OK) {  \
+                                bench_pause(&spins);                           \
+                        }                                                      \
+                        samples[i] = bench_now_ns() - t0;                      \
+                }                                                              \
+                pthread_join(th, NULL);                                        \
+                bench_report_rtt(layout, (size), (cap), samples,               \
+                                 BENCH_RTT_SAMPLES);                           \
+        }
+
+#define BENCH_CONFIGS(X)                                                       \
+        X(QUEUE_DEFINE, compact, 8, 64)                                        \
+        X(QUEUE_DEFINE, compact, 8, 1024)                                      \
+        X(QUEUE_DEFINE, compact, 64, 64)                                       \
+        X(QUEUE_DEFINE, compact, 64, 1024)                                     \
+        X(QUEUE_DEFINE, compact, 256, 1024)                                    \
+        X(QUEUE_DEFINE_PADDED, padded, 8, 64)                                  \
+        X(QUEUE_DEFINE_PADDED, padded, 8, 1024)                                \
+        X(QUEUE_DEFINE_PADDED, padded, 64, 64)                                 \
+        X(QUEUE_DEFINE_PADDED, padded, 64, 1024)                               \
+        X(QUEUE_DEFINE_PADDED, padded, 256, 1024)                              \
+        X(BENCH_QUEUE_RUNTIME, runtime, 8, 1024)                               \
+        X(BENCH_QUEUE_RUNTIME, runtime, 64, 1024)                              \
+        X(BENCH_QUEUE_RUNTIME_PADDED, runtime_padded, 8, 1024)                 \
+        X(BENCH_QUEUE_RUNTIME_PADDED, runtime_padded, 64, 1024)                \
+        X(QUEUE_DEFINE_OUTLINE, outline, 8, 1024)                              \
+        X(QUEUE_DEFINE_OUTLINE, outline, 64, 1024)
+
+#define BENCH_DEFINE(DEF, layout, size, cap)                                   \
+        BENCH__DEFINE_IMPL(DEF, bench_##layout##_##size##_##cap, #layout,      \
+                           size, cap)
+
+BENCH_CONFIGS(BENCH_DEFINE)
+
+#define BENCH_RUN(DEF, layout, size, cap) bench_##layout##_##size##_##cap();
+
+int
+main(int argc, char **argv)
+{
+        for (int i = 1; i + 1 < argc; i += 2) {
+                if (strcmp(argv[i], "--iters") == 0) {
+                        bench_iters = (size_t)strtoull(argv[i + 1], NULL, 10);
+                } else if (strcmp(argv[i], "--cores") == 0) {
+                        if (sscanf(argv[i + 1], "%d,%d", &bench_cores[0],
+                                   &bench_cores[1]) != 2) {
+                                fprintf(stderr, "bad --cores '%s'\n",
+                                        argv[i + 1]);
+                                return 1;
+                        }
+                } else {
+                        fprintf(stderr, "unknown option '%s'\n", argv[i]);
+                        return 1;
+                }
+        }
+        if (bench_iters == 0U) {
+                bench_iters = 1U;
+        }
+
+        /* Cores outside our affinity mask are reported as -1 (unpinned). */
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        (void)sched_getaffinity(0, sizeof(allowed), &allowed);
+        for (size_t i = 0; i < 2U; i++) {
+                if ((bench_cores[i] >= 0) &&
+                    ((bench_cores[i] >= CPU_SETSIZE) ||
+                     !CPU_ISSET(bench_cores[i], &allowed))) {
+                        fprintf(stderr, "core %d not available, unpinned\n",
+                                bench_cores[i]);
+                        bench_cores[i] = -1;
+                }
+        }
+
+        BENCH_CONFIGS(BENCH_RUN)
+        return 0;
+}
@@ -1,7 +1,280 @@
 #include "queue.h"
 
 /*
- * Header-only implementation.
+ * Out-of-line, element-size parameterised queue core.
  *
- * This translation unit exists so Meson can build a `libqueue` artifact.
+ * The typed QUEUE_DEFINE* macros stay header-only; this translation unit
+ * holds the shared implementation behind QUEUE_DEFINE_OUTLINE and direct
+ * queue_core_t users. The index protocol matches QUEUE_DEFINE (sentinel
+ * slot, release/acquire publication); only the element copy and the full
+ * policy are resolved at run time.
  */
+
+static inline unsigned char *
+queue_core__slot(const queue_core_t *q, size_t index)
+{
+        return q->buffer + (index * q->elem_size);
+}
+
+queue_status_t
+queue_core_init(queue_core_t *q, void *storage, size_t elem_size, size_t slots,
+                bool overwrite)
+{
+        if (!q || !storage || (elem_size == 0U) || (slots < 2U)) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        q->buffer = (unsigned char *)storage;
+        q->elem_size = elem_size;
+        q->ring_size = slots;
+        q->overwrite = overwrite;
+        queue__store_relaxed(&q->head, 0U);
+        queue__store_relaxed(&q->tail, 0U);
+        return QUEUE_STATUS_OK;
+}
+
+void
+queue_core_clear(queue_core_t *q)
+{
+        if (!q) {
+                return;
+        }
+        queue__store_relaxed(&q->head, 0U);
+        queue__store_relaxed(&q->tail, 0U);
+}
+
+bool
+queue_core_is_empty(const queue_core_t *q)
+{
+        return !q ||
+               (queue__load_acquire(&q->head) == queue__load_acquire(&q->tail));
+}
+
+bool
+queue_core_is_full(const queue_core_t *q)
+{
+        if (!q) {
+                return false;
+        }
+        return queue__next_index(queue__load_acquire(&q->head),
+                                 q->ring_size) ==
+               queue__load_acquire(&q->tail);
+}
+
+size_t
+queue_core_count(const queue_core_t *q)
+{
+        if (!q) {
+                return 0U;
+        }
+        const size_t head = queue__load_acquire(&q->head);
+        const size_t tail = queue__load_acquire(&q->tail);
+        return queue__ring_count(head, tail, q->ring_size);
+}
+
+queue_status_t
+queue_core_enqueue(queue_core_t *q, const void *item)
+{
+        if (!q || !item) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        queue_status_t status = QUEUE_STATUS_OK;
+        const size_t head = queue__load_relaxed(&q->head);
+        const size_t next_head = queue__next_index(head, q->ring_size);
+        if (next_head == queue__load_acquire(&q->tail)) {
+                if (!q->overwrite) {
+                        return QUEUE_STATUS_FULL;
+                }
+                queue__store_release(
+                    &q->tail, queue__next_index(queue__load_relaxed(&q->tail),
+                                                q->ring_size));
+                status = QUEUE_STATUS_OVERWROTE;
+        }
+        memcpy(queue_core__slot(q, head), item, q->elem_size);
+        queue__store_release(&q->head, next_head);
+        return status;
+}
+
+queue_status_t
+queue_core_dequeue(queue_core_t *q, void *out)
+{
+        if (!q || !out) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        const size_t tail = queue__load_relaxed(&q->tail);
+        if (queue__load_acquire(&q->head) == tail) {
+                return QUEUE_STATUS_EMPTY;
+        }
+        memcpy(out, queue_core__slot(q, tail), q->elem_size);
+        queue__store_release(&q->tail, queue__next_index(tail, q->ring_size));
+        return QUEUE_STATUS_OK;
+}
+
+queue_status_t
+queue_core_enqueue_bulk(queue_core_t *q, const void *items, size_t n,
+                        size_t *written)
+{
+        if (!q || !items || !written) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        const unsigned char *src = (const unsigned char *)items;
+        const size_t ring_size = q->ring_size;
+        const size_t capacity = ring_size - 1U;
+        queue_status_t status = QUEUE_STATUS_OK;
+        size_t k = n;
+        const size_t head = queue__load_relaxed(&q->head);
+        const size_t tail = queue__load_acquire(&q->tail);
+        const size_t used = queue__ring_count(head, tail, ring_size);
+        if (q->overwrite) {
+                if (k > capacity) {
+                        src += (k - capacity) * q->elem_size;
+                        k = capacity;
+                        status = QUEUE_STATUS_OVERWROTE;
+                }
+                if (used + k > capacity) {
+                        queue__store_release(
+                            &q->tail, queue__ring_add(tail, used + k - capacity,
+                                                      ring_size));
+                        status = QUEUE_STATUS_OVERWROTE;
+                }
+                *written = n;
+        } else {
+                if (k > capacity - used) {
+                        k = capacity - used;
+                        status = QUEUE_STATUS_FULL;
+                }
+                *written = k;
+        }
+        const size_t first = (k < ring_size - head) ? k : (ring_size - head);
+        memcpy(queue_core__slot(q, head), src, first * q->elem_size);
+        memcpy(q->buffer, src + (first * q->elem_size),
+               (k - first) * q->elem_size);
+        queue__store_release(&q->head, queue__ring_add(head, k, ring_size));
+        return status;
+}
+
+queue_status_t
+queue_core_dequeue_bulk(queue_core_t *q, void *out, size_t max, size_t *read)
+{
+        if (!q || !out || !read) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        unsigned char *dst = (unsigned char *)out;
+        const size_t ring_size = q->ring_size;
+        *read = 0U;
+        const size_t tail = queue__load_relaxed(&q->tail);
+        const size_t head = queue__load_acquire(&q->head);
+        const size_t avail = queue__ring_count(head, tail, ring_size);
+        if (avail == 0U) {
+                return QUEUE_STATUS_EMPTY;
+        }
+        const size_t k = (max < avail) ? max : avail;
+        const size_t first = (k < ring_size - tail) ? k : (ring_size - tail);
+        memcpy(dst, queue_core__slot(q, tail), first * q->elem_size);
+        memcpy(dst + (first * q->elem_size), q->buffer,
+               (k - first) * q->elem_size);
+        queue__store_release(&q->tail, queue__ring_add(tail, k, ring_size));
+        *read = k;
+        return QUEUE_STATUS_OK;
+}
+
+size_t
+queue_core_consume(queue_core_t *q, size_t max,
+                   void (*fn)(void *item, void *ctx), void *ctx)
+{
+        if (!q || !fn) {
+                return 0U;
+        }
+        const size_t ring_size = q->ring_size;
+        const size_t tail = queue__load_relaxed(&q->tail);
+        const size_t head = queue__load_acquire(&q->head);
+        const size_t avail = queue__ring_count(head, tail, ring_size);
+        const size_t k = (max < avail) ? max : avail;
+        const size_t first = (k < ring_size - tail) ? k : (ring_size - tail);
+        for (size_t i = 0U; i < first; i++) {
+                fn(queue_core__slot(q, tail + i), ctx);
+        }
+        for (size_t i = 0U; i < k - first; i++) {
+                fn(queue_core__slot(q, i), ctx);
+        }
+        if (k != 0U) {
+                queue__store_release(&q->tail,
+                                     queue__ring_add(tail, k, ring_size));
+        }
+        return k;
+}
+
+void *
+queue_core_reserve(queue_core_t *q)
+{
+        if (!q) {
+                return NULL;
+        }
+        const size_t head = queue__load_relaxed(&q->head);
+        if (queue__next_index(head, q->ring_size) ==
+            queue__load_acquire(&q->tail)) {
+                return NULL;
+        }
+        return queue_core__slot(q, head);
+}
+
+void *
+queue_core_reserve_span(queue_core_t *q, size_t *len)
+{
+        if (!q || !len) {
+                return NULL;
+        }
+        size_t n;
+        const size_t head = queue__load_relaxed(&q->head);
+        const size_t tail = queue__load_acquire(&q->tail);
+        if (tail > head) {
+                n = tail - head - 1U;
+        } else {
+                n = q->ring_size - head - ((tail == 0U) ? 1U : 0U);
+        }
+        *len = n;
+        return (n != 0U) ? queue_core__slot(q, head) : NULL;
+}
+
+queue_status_t
+queue_core_commit_n(queue_core_t *q, size_t n)
+{
+        if (!q) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        const size_t head = queue__load_relaxed(&q->head);
+        const size_t used = queue__ring_count(
+            head, queue__load_acquire(&q->tail), q->ring_size);
+        if (n > q->ring_size - 1U - used) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        queue__store_release(&q->head,
+                             queue__ring_add(head, n, q->ring_size));
+        return QUEUE_STATUS_OK;
+}
+
+void *
+queue_core_peek(queue_core_t *q)
+{
+        if (!q) {
+                return NULL;
+        }
+        const size_t tail = queue__load_relaxed(&q->tail);
+        if (queue__load_acquire(&q->head) == tail) {
+                return NULL;
+        }
+        return queue_core__slot(q, tail);
+}
+
+queue_status_t
+queue_core_release(queue_core_t *q)
+{
+        if (!q) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        const size_t tail = queue__load_relaxed(&q->tail);
+        if (queue__load_acquire(&q->head) == tail) {
+                return QUEUE_STATUS_EMPTY;
+        }
+        queue__store_release(&q->tail, queue__next_index(tail, q->ring_size));
+        return QUEUE_STATUS_OK;
+}
@@ -10,10 +10,15 @@
  *
  * Concurrency notes:
  * - This is a Single-Producer Single-Consumer (SPSC) queue.
+ * - Index backend (QUEUE_USE_C11_ATOMICS):
+ *   - 1 (default on hosted C11): head/tail are `_Atomic size_t`; the side that
+ * publishes an index uses a release store and the other side an acquire load.
+ * Correct on weakly ordered CPUs (ARM/AArch64) without seq_cst fences.
+ *   - 0 (default on freestanding/pre-C11): head/tail are `volatile size_t`
+ * ordered by QUEUE_BARRIER(), which is only a compiler barrier.
  * - In "Fail-on-full" mode (QUEUE_OVERWRITE_ON_FULL=0):
- *   - Lock-free if the platform has atomic size_t writes and no memory
- * reordering.
- *   - Internal memory barriers are included to help prevent reordering.
+ *   - Lock-free with the C11 atomics backend. With the volatile backend only
+ * if the platform has atomic size_t writes and no memory reordering.
  * - In "Overwrite-on-full" mode (QUEUE_OVERWRITE_ON_FULL=1):
  *   - NOT lock-free! The producer modifies 'tail', which is also modified by
  * the consumer.
@@ -28,6 +33,7 @@
 #include "queue_version.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 
 #if defined(__GNUC__) || defined(__clang__)
 #define QUEUE__UNUSED __attribute__((unused))
@@ -39,6 +45,89 @@
 #define QUEUE_OVERWRITE_ON_FULL 1
 #endif
 
+#ifndef QUEUE_ENABLE_STATS
+#define QUEUE_ENABLE_STATS 0
+#endif
+
+#ifndef QUEUE_ENABLE_WAIT
+#define QUEUE_ENABLE_WAIT 0
+#endif
+
+#ifndef QUEUE_ENABLE_NOTIFY
+#define QUEUE_ENABLE_NOTIFY 0
+#endif
+
+#ifndef QUEUE_ENABLE_TRACE
+#define QUEUE_ENABLE_TRACE 0
+#endif
+
+#ifndef QUEUE_ENABLE_SET
+#define QUEUE_ENABLE_SET 0
+#endif
+
+#ifndef QUEUE_USE_C11_ATOMICS
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) &&              \
+    !defined(__STDC_NO_ATOMICS__) && (__STDC_HOSTED__ == 1)
+#define QUEUE_USE_C11_ATOMICS 1
+#else
+#define QUEUE_USE_C11_ATOMICS 0
+#endif
+#endif
+
+#if QUEUE_USE_C11_ATOMICS
+#include <stdatomic.h>
+#endif
+
+#if QUEUE_ENABLE_WAIT
+#if !QUEUE_USE_C11_ATOMICS || !defined(__linux__)
+#error "QUEUE_ENABLE_WAIT requires Linux and QUEUE_USE_C11_ATOMICS=1"
+#endif
+#include <linux/futex.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if QUEUE_ENABLE_NOTIFY
+#if !QUEUE_USE_C11_ATOMICS || !defined(__linux__)
+#error "QUEUE_ENABLE_NOTIFY requires Linux and QUEUE_USE_C11_ATOMICS=1"
+#endif
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#if QUEUE_ENABLE_TRACE
+#ifndef QUEUE_TRACE_CLOCK
+#error "QUEUE_ENABLE_TRACE requires a QUEUE_TRACE_CLOCK() returning uint64_t"
+#endif
+#include <stdint.h>
+#endif
+
+#if QUEUE_ENABLE_SET
+#include <stdint.h>
+#endif
+
+#ifndef QUEUE_CACHE_LINE_SIZE
+#define QUEUE_CACHE_LINE_SIZE 64U
+#endif
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define QUEUE__ALIGNED(n) _Alignas(n)
+#elif defined(__GNUC__) || defined(__clang__)
+#define QUEUE__ALIGNED(n) __attribute__((aligned(n)))
+#else
+#define QUEUE__ALIGNED(n)
+#endif
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define QUEUE__STATIC_ASSERT(name, cond, msg) _Static_assert(cond, msg)
+#else
+#define QUEUE__STATIC_ASSERT(name, cond, msg)                                  \
+        typedef char name##_static_assert[(cond) ? 1 : -1]
+#endif
+
 #ifndef QUEUE_BARRIER
 #if defined(__GNUC__) || defined(__clang__)
 #define QUEUE_BARRIER() __asm__ volatile("" : : : "memory")
@@ -60,14 +149,105 @@
 #endif
 
 typedef enum {
-        QUEUE_STATUS_OK = 0,   /* operation successful */
-        QUEUE_STATUS_EMPTY,    /* dequeue attempted on empty queue */
-        QUEUE_STATUS_FULL,     /* enqueue attempted on full queue (non‑overwrite
-                                  mode) */
-        QUEUE_STATUS_BAD_ARG,  /* NULL pointer passed to API */
-        QUEUE_STATUS_OVERWROTE /* item enqueued by overwriting oldest element */
+        QUEUE_STATUS_OK = 0,    /* operation successful */
+        QUEUE_STATUS_EMPTY,     /* dequeue attempted on empty queue */
+        QUEUE_STATUS_FULL,      /* enqueue attempted on full queue
+                                   (non‑overwrite mode) */
+        QUEUE_STATUS_BAD_ARG,   /* NULL pointer passed to API */
+        QUEUE_STATUS_OVERWROTE, /* item enqueued by overwriting oldest
+                                   element */
+        QUEUE_STATUS_MISMATCH,  /* attached queue has an incompatible layout */
+        QUEUE_STATUS_SYS_ERROR  /* OS call failed; see errno */
 } queue_status_t;
 
+/*
+ * Index access helpers.
+ *
+ * `relaxed` is for the side that owns the index (or under a critical
+ * section), `acquire` for observing the other side's index before touching
+ * the slots it published, `release` for publishing after the slot access.
+ */
+#if QUEUE_USE_C11_ATOMICS
+typedef _Atomic size_t queue__index_t;
+
+static inline size_t
+queue__load_relaxed(const queue__index_t *p)
+{
+        return atomic_load_explicit((queue__index_t *)p, memory_order_relaxed);
+}
+
+static inline size_t
+queue__load_acquire(const queue__index_t *p)
+{
+        return atomic_load_explicit((queue__index_t *)p, memory_order_acquire);
+}
+
+static inline void
+queue__store_relaxed(queue__index_t *p, size_t v)
+{
+        atomic_store_explicit(p, v, memory_order_relaxed);
+}
+
+static inline void
+queue__store_release(queue__index_t *p, size_t v)
+{
+        atomic_store_explicit(p, v, memory_order_release);
+}
+
+static inline void
+queue__fence_acquire(void)
+{
+        atomic_thread_fence(memory_order_acquire);
+}
+
+static inline void
+queue__fence_release(void)
+{
+        atomic_thread_fence(memory_order_release);
+}
+#else
+typedef volatile size_t queue__index_t;
+
+static inline size_t
+queue__load_relaxed(const queue__index_t *p)
+{
+        return *p;
+}
+
+static inline size_t
+queue__load_acquire(const queue__index_t *p)
+{
+        size_t v = *p;
+        QUEUE_BARRIER();
+        return v;
+}
+
+static inline void
+queue__store_relaxed(queue__index_t *p, size_t v)
+{
+        *p = v;
+}
+
+static inline void
+queue__store_release(queue__index_t *p, size_t v)
+{
+        QUEUE_BARRIER();
+        *p = v;
+}
+
+static inline void
+queue__fence_acquire(void)
+{
+        QUEUE_BARRIER();
+}
+
+static inline void
+queue__fence_release(void)
+{
+        QUEUE_BARRIER();
+}
+#endif
+
 static inline size_t
 queue__next_index(size_t index, size_t ring_size)
 {
@@ -78,10 +258,35 @@ queue__next_index(size_t index, size_t ring_size)
         return index;
 }
 
+/* `index + n` on a ring of `ring_size` slots, for n <= ring_size. */
+static inline size_t
+queue__ring_add(size_t index, size_t n, size_t ring_size)
+{
+        return (n >= ring_size - index) ? (index + n - ring_size) : (index + n);
+}
+
+static inline size_t
+queue__ring_count(size_t head, size_t tail, size_t ring_size)
+{
+        if (head >= tail) {
+                return head - tail;
+        }
+        return ring_size - (tail - head);
+}
+
 #if QUEUE_OVERWRITE_ON_FULL
 #define QUEUE__HANDLE_FULL(q, ring_size, status_var)                           \
         do {                                                                   \
-                (q)->tail = queue__next_index((q)->tail, (ring_size));         \
+                queue__store_release(                                          \
+                    &(q)->tail,                                                \
+                    queue__next_index(queue__load_relaxed(&(q)->tail),         \
+                                      (ring_size)));                           \
+                (status_var) = QUEUE_STATUS_OVERWROTE;                         \
+        } while (0)
+#define QUEUE__HANDLE_FULL_POW2(q, status_var)                                 \
+        do {                                                                   \
+                queue__store_release(&(q)->tail,                               \
+                                     queue__load_relaxed(&(q)->tail) + 1U);    \
                 (status_var) = QUEUE_STATUS_OVERWROTE;                         \
         } while (0)
 #else
@@ -91,113 +296,1804 @@ queue__next_index(size_t index, size_t ring_size)
                 (void)(ring_size);                                             \
                 (status_var) = QUEUE_STATUS_FULL;                              \
         } while (0)
+#define QUEUE__HANDLE_FULL_POW2(q, status_var)                                 \
+        do {                                                                   \
+                (void)(q);                                                     \
+                (status_var) = QUEUE_STATUS_FULL;                              \
+        } while (0)
 #endif
 
 /*
- * QUEUE_DEFINE(name, type, capacity)
- *
- * Defines:
- * - type: `name##_t`
- * - functions: `name##_init`, `name##_enqueue`, `name##_dequeue`, ...
+ * Statistics (QUEUE_ENABLE_STATS=1).
  *
- * `capacity` is the usable element capacity.
+ * Adds counters to queues from QUEUE_DEFINE, QUEUE_DEFINE_PADDED and
+ * QUEUE_DEFINE_POW2, plus `name##_stats(q, &snapshot)` and
+ * `name##_stats_reset(q)`. Producer-side counters (enqueued, overwritten,
+ * full, high_watermark) are only written by the producer and `dequeued` only
+ * by the consumer, with plain relaxed load/store, so there is no shared
+ * read-modify-write. `full` counts rejected items. `high_watermark` is the
+ * largest count seen by the producer right after an enqueue; in padded
+ * queues it is computed from the producer's cached tail and is therefore an
+ * upper bound. `name##_stats_reset` must not run concurrently with the
+ * producer or consumer; `name##_init` also zeroes the counters, `name##_clear`
+ * leaves them. With QUEUE_ENABLE_STATS=0 (default) nothing is
+ * added.
  */
-#define QUEUE_DEFINE(name, type, capacity)                                     \
-        typedef struct {                                                       \
-                type buffer[(capacity) + 1U];                                  \
-                volatile size_t head;                                          \
-                volatile size_t tail;                                          \
-        } name##_t;                                                            \
-                                                                               \
-        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+typedef struct {
+        size_t enqueued;
+        size_t dequeued;
+        size_t overwritten;
+        size_t full;
+        size_t high_watermark;
+} queue_stats_t;
+
+#if QUEUE_ENABLE_STATS
+static inline void
+queue__stat_add(queue__index_t *p, size_t n)
+{
+        queue__store_relaxed(p, queue__load_relaxed(p) + n);
+}
+
+static inline void
+queue__stat_max(queue__index_t *p, size_t v)
+{
+        if (v > queue__load_relaxed(p)) {
+                queue__store_relaxed(p, v);
+        }
+}
+
+#define QUEUE__STATS_FIELDS_COMPACT                                            \
+        queue__index_t stat_enqueued;                                          \
+        queue__index_t stat_overwritten;                                       \
+        queue__index_t stat_full;                                              \
+        queue__index_t stat_high_watermark;                                    \
+        queue__index_t stat_dequeued;
+
+#define QUEUE__STATS_FIELDS_PADDED                                             \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t stat_enqueued;    \
+        queue__index_t stat_overwritten;                                       \
+        queue__index_t stat_full;                                              \
+        queue__index_t stat_high_watermark;                                    \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t stat_dequeued;
+
+#define QUEUE__STAT_PRODUCE(q, accepted, overwritten, rejected, depth)         \
+        do {                                                                   \
+                queue__stat_add(&(q)->stat_enqueued, (accepted));              \
+                queue__stat_add(&(q)->stat_overwritten, (overwritten));        \
+                queue__stat_add(&(q)->stat_full, (rejected));                  \
+                queue__stat_max(&(q)->stat_high_watermark, (depth));           \
+        } while (0)
+
+#define QUEUE__STAT_CONSUME(q, n) queue__stat_add(&(q)->stat_dequeued, (n))
+#define QUEUE__STATS_INIT(name, q) name##_stats_reset(q)
+
+#define QUEUE__STATS_DEFINE(name)                                              \
+        static inline QUEUE__UNUSED void name##_stats(const name##_t *q,       \
+                                                      queue_stats_t *out)      \
         {                                                                      \
-                if (!q) {                                                      \
+                if (!q || !out) {                                              \
                         return;                                                \
                 }                                                              \
-                q->head = 0U;                                                  \
-                q->tail = 0U;                                                  \
+                out->enqueued = queue__load_relaxed(&q->stat_enqueued);        \
+                out->dequeued = queue__load_relaxed(&q->stat_dequeued);        \
+                out->overwritten = queue__load_relaxed(&q->stat_overwritten);  \
+                out->full = queue__load_relaxed(&q->stat_full);                \
+                out->high_watermark =                                          \
+                    queue__load_relaxed(&q->stat_high_watermark);              \
         }                                                                      \
-        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        static inline QUEUE__UNUSED void name##_stats_reset(name##_t *q)       \
         {                                                                      \
                 if (!q) {                                                      \
                         return;                                                \
                 }                                                              \
-                q->head = 0U;                                                  \
-                q->tail = 0U;                                                  \
-        }                                                                      \
-        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
-        {                                                                      \
-                return !q || (q->head == q->tail);                             \
-        }                                                                      \
-        static inline QUEUE__UNUSED bool name##_is_full(const name##_t *q)     \
-        {                                                                      \
-                if (!q) {                                                      \
-                        return false;                                          \
+                queue__store_relaxed(&q->stat_enqueued, 0U);                   \
+                queue__store_relaxed(&q->stat_dequeued, 0U);                   \
+                queue__store_relaxed(&q->stat_overwritten, 0U);                \
+                queue__store_relaxed(&q->stat_full, 0U);                       \
+                queue__store_relaxed(&q->stat_high_watermark, 0U);             \
+        }
+#else
+#define QUEUE__STATS_FIELDS_COMPACT
+#define QUEUE__STATS_FIELDS_PADDED
+#define QUEUE__STAT_PRODUCE(q, accepted, overwritten, rejected, depth)         \
+        ((void)0)
+#define QUEUE__STAT_CONSUME(q, n) ((void)0)
+#define QUEUE__STATS_INIT(name, q) ((void)0)
+#define QUEUE__STATS_DEFINE(name)
+#endif
+
+/*
+ * Blocking waits (QUEUE_ENABLE_WAIT=1, Linux only).
+ *
+ * Adds `name##_dequeue_wait(q, out, timeout_ns)` and
+ * `name##_enqueue_wait(q, item, timeout_ns)` to queues from QUEUE_DEFINE and
+ * QUEUE_DEFINE_PADDED. They retry the non-blocking call QUEUE_WAIT_SPIN times
+ * and then park on a futex keyed to the low 32 bits of the index the other
+ * side publishes (`head` for consumers, `tail` for producers). `timeout_ns`
+ * < 0 waits forever, 0 never blocks; on timeout QUEUE_STATUS_EMPTY/FULL is
+ * returned. Waiters register in `wait_consumers`/`wait_producers` before
+ * re-checking the index, and the publishing side issues FUTEX_WAKE only if
+ * that count is non-zero, so the non-blocking calls stay syscall-free (at the
+ * cost of one seq_cst fence each). Requires _DEFAULT_SOURCE/_GNU_SOURCE for
+ * syscall() and clock_gettime().
+ */
+#ifndef QUEUE_WAIT_SPIN
+#define QUEUE_WAIT_SPIN 1024U
+#endif
+
+#if QUEUE_ENABLE_WAIT
+#if defined(__x86_64__) || defined(__i386__)
+#define QUEUE__CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define QUEUE__CPU_RELAX() __asm__ volatile("yield" : : : "memory")
+#else
+#define QUEUE__CPU_RELAX() QUEUE_BARRIER()
+#endif
+
+/* The 32-bit futex word overlaying the low half of an index. */
+static inline uint32_t *
+queue__futex_word(queue__index_t *index)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        return (uint32_t *)(void *)index +
+               ((sizeof(size_t) / sizeof(uint32_t)) - 1U);
+#else
+        return (uint32_t *)(void *)index;
+#endif
+}
+
+static inline int64_t
+queue__now_ns(void)
+{
+        struct timespec ts;
+        (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ((int64_t)ts.tv_sec * 1000000000) + (int64_t)ts.tv_nsec;
+}
+
+/* Sleep while the index still equals `seen`, for at most `timeout_ns`. */
+static inline void
+queue__futex_wait(queue__index_t *index, size_t seen, int64_t timeout_ns)
+{
+        struct timespec ts;
+        ts.tv_sec = (time_t)(timeout_ns / 1000000000);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000);
+        (void)syscall(SYS_futex, queue__futex_word(index), FUTEX_WAIT_PRIVATE,
+                      (uint32_t)seen, (timeout_ns < 0) ? NULL : &ts, NULL, 0);
+}
+
+/* Publishing side: wake sleepers only if any registered. */
+static inline void
+queue__wait_notify(queue__index_t *index, atomic_uint *waiters)
+{
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(waiters, memory_order_relaxed) != 0U) {
+                (void)syscall(SYS_futex, queue__futex_word(index),
+                              FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+        }
+}
+
+/*
+ * Waiting side: register, re-check that `index` still equals `seen` and park.
+ * Returns false once `deadline` (ns, < 0 = none) has passed.
+ */
+static inline bool
+queue__wait_park(queue__index_t *index, size_t seen, atomic_uint *waiters,
+                 int64_t deadline)
+{
+        int64_t left = -1;
+        if (deadline >= 0) {
+                left = deadline - queue__now_ns();
+                if (left <= 0) {
+                        return false;
+                }
+        }
+        atomic_fetch_add_explicit(waiters, 1U, memory_order_seq_cst);
+        if (atomic_load_explicit(index, memory_order_seq_cst) == seen) {
+                queue__futex_wait(index, seen, left);
+        }
+        atomic_fetch_sub_explicit(waiters, 1U, memory_order_relaxed);
+        return true;
+}
+
+#define QUEUE__WAIT_FIELDS                                                     \
+        atomic_uint wait_consumers;                                            \
+        atomic_uint wait_producers;
+
+#define QUEUE__WAIT_RESET(q)                                                   \
+        (atomic_store(&(q)->wait_consumers, 0U),                               \
+         atomic_store(&(q)->wait_producers, 0U))
+
+#define QUEUE__WAKE_CONSUMER(q, cond)                                          \
+        do {                                                                   \
+                if (cond) {                                                    \
+                        queue__wait_notify(&(q)->head, &(q)->wait_consumers);  \
                 }                                                              \
-                const size_t ring_size = (capacity) + 1U;                      \
-                return queue__next_index(q->head, ring_size) == q->tail;       \
-        }                                                                      \
-        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        } while (0)
+
+#define QUEUE__WAKE_PRODUCER(q, cond)                                          \
+        do {                                                                   \
+                if (cond) {                                                    \
+                        queue__wait_notify(&(q)->tail, &(q)->wait_producers);  \
+                }                                                              \
+        } while (0)
+
+#define QUEUE__WAIT_DEFINE(name, type, capacity)                               \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue_wait(        \
+            name##_t *q, type *out, int64_t timeout_ns)                        \
         {                                                                      \
-                return (capacity);                                             \
+                queue_status_t st = name##_dequeue(q, out);                    \
+                if ((st != QUEUE_STATUS_EMPTY) || (timeout_ns == 0)) {         \
+                        return st;                                             \
+                }                                                              \
+                const int64_t deadline =                                       \
+                    (timeout_ns < 0) ? -1 : (queue__now_ns() + timeout_ns);    \
+                for (unsigned i = 0U; i < QUEUE_WAIT_SPIN; i++) {              \
+                        QUEUE__CPU_RELAX();                                    \
+                        st = name##_dequeue(q, out);                           \
+                        if (st != QUEUE_STATUS_EMPTY) {                        \
+                                return st;                                     \
+                        }                                                      \
+                }                                                              \
+                for (;;) {                                                     \
+                        const size_t tail = queue__load_relaxed(&q->tail);     \
+                        if (!queue__wait_park(&q->head, tail,                  \
+                                              &q->wait_consumers, deadline)) { \
+                                return QUEUE_STATUS_EMPTY;                     \
+                        }                                                      \
+                        st = name##_dequeue(q, out);                           \
+                        if (st != QUEUE_STATUS_EMPTY) {                        \
+                                return st;                                     \
+                        }                                                      \
+                }                                                              \
         }                                                                      \
-        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue_wait(        \
+            name##_t *q, const type *item, int64_t timeout_ns)                 \
         {                                                                      \
-                if (!q) {                                                      \
-                        return 0;                                              \
+                queue_status_t st = name##_enqueue(q, item);                   \
+                if ((st != QUEUE_STATUS_FULL) || (timeout_ns == 0)) {          \
+                        return st;                                             \
                 }                                                              \
-                const size_t ring_size = (capacity) + 1U;                      \
-                if (q->head >= q->tail) {                                      \
-                        return q->head - q->tail;                              \
+                const int64_t deadline =                                       \
+                    (timeout_ns < 0) ? -1 : (queue__now_ns() + timeout_ns);    \
+                for (unsigned i = 0U; i < QUEUE_WAIT_SPIN; i++) {              \
+                        QUEUE__CPU_RELAX();                                    \
+                        st = name##_enqueue(q, item);                          \
+                        if (st != QUEUE_STATUS_FULL) {                         \
+                                return st;                                     \
+                        }                                                      \
                 }                                                              \
-                return ring_size - (q->tail - q->head);                        \
-        }                                                                      \
-        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
-            name##_t *q, const type *item)                                     \
+                for (;;) {                                                     \
+                        const size_t full_tail = queue__next_index(            \
+                            queue__load_relaxed(&q->head), (capacity) + 1U);   \
+                        if (!queue__wait_park(&q->tail, full_tail,             \
+                                              &q->wait_producers, deadline)) { \
+                                return QUEUE_STATUS_FULL;                      \
+                        }                                                      \
+                        st = name##_enqueue(q, item);                          \
+                        if (st != QUEUE_STATUS_FULL) {                         \
+                                return st;                                     \
+                        }                                                      \
+                }                                                              \
+        }
+#else
+#define QUEUE__WAIT_FIELDS
+#define QUEUE__WAIT_RESET(q) ((void)0)
+#define QUEUE__WAKE_CONSUMER(q, cond) ((void)0)
+#define QUEUE__WAKE_PRODUCER(q, cond) ((void)0)
+#define QUEUE__WAIT_DEFINE(name, type, capacity)
+#endif
+
+/*
+ * Event-loop notification (QUEUE_ENABLE_NOTIFY=1, Linux only).
+ *
+ * `name##_notify_open(q)` (after init) attaches a non-blocking eventfd that
+ * becomes readable when data is published while the consumer is "armed".
+ * The first publish after arming disarms and writes the eventfd once, so a
+ * burst costs a single syscall. The consumer drains the queue and then calls
+ * `name##_notify_rearm(q)`, which clears the eventfd, re-arms and returns
+ * true if items arrived in the meantime (keep draining in that case).
+ */
+#if QUEUE_ENABLE_NOTIFY
+static inline void
+queue__notify_signal(int fd, atomic_bool *armed)
+{
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(armed, memory_order_relaxed) &&
+            atomic_exchange_explicit(armed, false, memory_order_relaxed)) {
+                const uint64_t one = 1U;
+                (void)!write(fd, &one, sizeof(one));
+        }
+}
+
+#define QUEUE__NOTIFY_FIELDS                                                   \
+        int notify_fd;                                                         \
+        atomic_bool notify_armed;
+
+#define QUEUE__NOTIFY_RESET(q)                                                 \
+        ((q)->notify_fd = -1, atomic_store(&(q)->notify_armed, false))
+
+#define QUEUE__NOTIFY(q, cond)                                                 \
+        do {                                                                   \
+                if (cond) {                                                    \
+                        queue__notify_signal((q)->notify_fd,                   \
+                                             &(q)->notify_armed);              \
+                }                                                              \
+        } while (0)
+
+#define QUEUE__NOTIFY_DEFINE(name)                                             \
+        static inline QUEUE__UNUSED int name##_notify_open(name##_t *q)        \
         {                                                                      \
-                if (!q || !item) {                                             \
-                        return QUEUE_STATUS_BAD_ARG;                           \
+                if (!q) {                                                      \
+                        return -1;                                             \
                 }                                                              \
-                const size_t ring_size = (capacity) + 1U;                      \
-                queue_status_t status = QUEUE_STATUS_OK;                       \
-                QUEUE_ENTER_CRITICAL();                                        \
-                size_t next_head = queue__next_index(q->head, ring_size);      \
-                if (next_head == q->tail) {                                    \
-                        QUEUE__HANDLE_FULL(q, ring_size, status);              \
+                if (q->notify_fd < 0) {                                        \
+                        q->notify_fd =                                         \
+                            eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);           \
                 }                                                              \
-                if (status != QUEUE_STATUS_FULL) {                             \
-                        q->buffer[q->head] = *item;                            \
-                        QUEUE_BARRIER();                                       \
-                        q->head = next_head;                                   \
+                if (q->notify_fd >= 0) {                                       \
+                        atomic_store(&q->notify_armed, true);                  \
                 }                                                              \
-                QUEUE_EXIT_CRITICAL();                                         \
-                return status;                                                 \
+                return q->notify_fd;                                           \
         }                                                                      \
-        static inline QUEUE__UNUSED queue_status_t name##_dequeue(name##_t *q, \
-                                                                  type *out)   \
+        static inline QUEUE__UNUSED int name##_notify_fd(const name##_t *q)    \
         {                                                                      \
-                if (!q || !out) {                                              \
-                        return QUEUE_STATUS_BAD_ARG;                           \
+                return q ? q->notify_fd : -1;                                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_notify_rearm(name##_t *q)      \
+        {                                                                      \
+                if (!q || (q->notify_fd < 0)) {                                \
+                        return false;                                          \
                 }                                                              \
-                const size_t ring_size = (capacity) + 1U;                      \
-                QUEUE_ENTER_CRITICAL();                                        \
-                if (q->head == q->tail) {                                      \
-                        QUEUE_EXIT_CRITICAL();                                 \
-                        return QUEUE_STATUS_EMPTY;                             \
+                uint64_t events;                                               \
+                (void)!read(q->notify_fd, &events, sizeof(events));            \
+                atomic_store(&q->notify_armed, true);                          \
+                atomic_thread_fence(memory_order_seq_cst);                     \
+                return !name##_is_empty(q);                                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_notify_close(name##_t *q)      \
+        {                                                                      \
+                if (!q || (q->notify_fd < 0)) {                                \
+                        return;                                                \
                 }                                                              \
-                *out = q->buffer[q->tail];                                     \
-                QUEUE_BARRIER();                                               \
-                q->tail = queue__next_index(q->tail, ring_size);               \
-                QUEUE_EXIT_CRITICAL();                                         \
-                return QUEUE_STATUS_OK;                                        \
+                (void)close(q->notify_fd);                                     \
+                QUEUE__NOTIFY_RESET(q);                                        \
+        }
+#else
+#define QUEUE__NOTIFY_FIELDS
+#define QUEUE__NOTIFY_RESET(q) ((void)0)
+#define QUEUE__NOTIFY(q, cond) ((void)0)
+#define QUEUE__NOTIFY_DEFINE(name)
+#endif
+
+/*
+ * Queue sets (QUEUE_ENABLE_SET=1).
+ *
+ * Up to 64 queues from QUEUE_DEFINE, QUEUE_DEFINE_PADDED or
+ * QUEUE_DEFINE_RUNTIME join a queue_set_t with `name##_set_attach(q, set,
+ * member)`. Publishing into a member sets bit `member` of the set's ready
+ * mask if it is clear (a load otherwise, so a busy queue touches no shared
+ * line), and the consumer finds work with one load of the mask plus
+ * count-trailing-zeros per ready member. The consumer clears a bit lazily:
+ * `name##_set_dequeue` (or `name##_set_rearm` after the bulk/zero-copy
+ * calls come up empty) clears it when the queue is found empty and then
+ * re-checks the queue, which closes the race with a concurrent publish.
+ * With QUEUE_ENABLE_WAIT, `queue_set_wait(set, timeout_ns)` blocks until
+ * some member is ready; a producer only enters the kernel when it sets a
+ * clear bit while the consumer sleeps. Attach and detach before or after
+ * concurrent use, not during it.
+ */
+#if QUEUE_ENABLE_SET
+#if QUEUE_USE_C11_ATOMICS
+typedef _Atomic uint64_t queue__set_mask_t;
+#else
+typedef volatile uint64_t queue__set_mask_t;
+#endif
+
+typedef struct {
+        queue__set_mask_t ready;
+#if QUEUE_ENABLE_WAIT
+        queue__index_t epoch;
+        atomic_uint waiters;
+#endif
+} queue_set_t;
+
+#define QUEUE_SET_MEMBERS 64U
+
+static inline void
+queue_set_init(queue_set_t *s)
+{
+        if (!s) {
+                return;
+        }
+        s->ready = 0U;
+#if QUEUE_ENABLE_WAIT
+        queue__store_relaxed(&s->epoch, 0U);
+        atomic_store(&s->waiters, 0U);
+#endif
+}
+
+/* Snapshot of the ready mask; bit n set: member n may hold items. */
+static inline uint64_t
+queue_set_ready(const queue_set_t *s)
+{
+        if (!s) {
+                return 0U;
+        }
+#if QUEUE_USE_C11_ATOMICS
+        return atomic_load_explicit((queue__set_mask_t *)&s->ready,
+                                    memory_order_acquire);
+#else
+        QUEUE_ENTER_CRITICAL();
+        const uint64_t v = s->ready;
+        QUEUE_EXIT_CRITICAL();
+        QUEUE_BARRIER();
+        return v;
+#endif
+}
+
+/* Remove the lowest member from a non-zero snapshot and return its number. */
+static inline unsigned
+queue_set_pop(uint64_t *mask)
+{
+        const uint64_t m = *mask;
+        *mask = m & (m - 1U);
+#if defined(__GNUC__)
+        return (unsigned)__builtin_ctzll(m);
+#else
+        unsigned n = 0U;
+        while (((m >> n) & 1U) == 0U) {
+                n++;
+        }
+        return n;
+#endif
+}
+
+/* Producer side: called after the member published. */
+static inline void
+queue__set_mark(queue_set_t *s, uint64_t bit)
+{
+#if QUEUE_USE_C11_ATOMICS
+        atomic_thread_fence(memory_order_seq_cst);
+        if ((atomic_load_explicit(&s->ready, memory_order_relaxed) & bit) !=
+            0U) {
+                return;
+        }
+        (void)atomic_fetch_or_explicit(&s->ready, bit, memory_order_release);
+#if QUEUE_ENABLE_WAIT
+        (void)atomic_fetch_add_explicit(&s->epoch, 1U, memory_order_seq_cst);
+        queue__wait_notify(&s->epoch, &s->waiters);
+#endif
+#else
+        QUEUE_ENTER_CRITICAL();
+        s->ready |= bit;
+        QUEUE_EXIT_CRITICAL();
+#endif
+}
+
+/* Consumer side: the caller must re-check the member afterwards. */
+static inline void
+queue__set_unmark(queue_set_t *s, uint64_t bit)
+{
+#if QUEUE_USE_C11_ATOMICS
+        (void)atomic_fetch_and_explicit(&s->ready, ~bit, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+#else
+        QUEUE_ENTER_CRITICAL();
+        s->ready &= ~bit;
+        QUEUE_EXIT_CRITICAL();
+#endif
+}
+
+#if QUEUE_ENABLE_WAIT
+/*
+ * Block until some member is ready; returns the ready mask, or 0 once
+ * `timeout_ns` (< 0: forever) has passed.
+ */
+static inline uint64_t
+queue_set_wait(queue_set_t *s, int64_t timeout_ns)
+{
+        uint64_t ready = queue_set_ready(s);
+        if (!s || (ready != 0U) || (timeout_ns == 0)) {
+                return ready;
+        }
+        const int64_t deadline =
+            (timeout_ns < 0) ? -1 : (queue__now_ns() + timeout_ns);
+        for (unsigned i = 0U; i < QUEUE_WAIT_SPIN; i++) {
+                QUEUE__CPU_RELAX();
+                ready = queue_set_ready(s);
+                if (ready != 0U) {
+                        return ready;
+                }
+        }
+        for (;;) {
+                const size_t seen =
+                    atomic_load_explicit(&s->epoch, memory_order_seq_cst);
+                ready = atomic_load_explicit(&s->ready, memory_order_seq_cst);
+                if (ready != 0U) {
+                        return ready;
+                }
+                if (!queue__wait_park(&s->epoch, seen, &s->waiters,
+                                      deadline)) {
+                        return 0U;
+                }
+        }
+}
+#endif
+
+#define QUEUE__SET_FIELDS                                                      \
+        queue_set_t *set;                                                      \
+        uint64_t set_bit;
+
+#define QUEUE__SET_RESET(q) ((q)->set = NULL, (q)->set_bit = 0U)
+
+#define QUEUE__SET_SIGNAL(q, cond)                                             \
+        do {                                                                   \
+                if ((cond) && ((q)->set != NULL)) {                            \
+                        queue__set_mark((q)->set, (q)->set_bit);               \
+                }                                                              \
+        } while (0)
+
+#define QUEUE__SET_DEFINE(name, type)                                          \
+        static inline QUEUE__UNUSED queue_status_t name##_set_attach(          \
+            name##_t *q, queue_set_t *set, unsigned member)                    \
+        {                                                                      \
+                if (!q || !set || (member >= QUEUE_SET_MEMBERS)) {             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                q->set_bit = (uint64_t)1U << member;                           \
+                q->set = set;                                                  \
+                QUEUE__SET_SIGNAL(q, !name##_is_empty(q));                     \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_set_detach(name##_t *q)        \
+        {                                                                      \
+                if (!q || !q->set) {                                           \
+                        return;                                                \
+                }                                                              \
+                queue__set_unmark(q->set, q->set_bit);                         \
+                QUEUE__SET_RESET(q);                                           \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_set_rearm(name##_t *q)         \
+        {                                                                      \
+                if (!q || !q->set) {                                           \
+                        return false;                                          \
+                }                                                              \
+                queue__set_unmark(q->set, q->set_bit);                         \
+                if (name##_is_empty(q)) {                                      \
+                        return false;                                          \
+                }                                                              \
+                queue__set_mark(q->set, q->set_bit);                           \
+                return true;                                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_set_dequeue(         \
+            name##_t *q, type *out)                                            \
+        {                                                                      \
+                queue_status_t st = name##_dequeue(q, out);                    \
+                if ((st == QUEUE_STATUS_EMPTY) && name##_set_rearm(q)) {       \
+                        st = name##_dequeue(q, out);                           \
+                }                                                              \
+                return st;                                                     \
+        }
+#else
+#define QUEUE__SET_FIELDS
+#define QUEUE__SET_RESET(q) ((void)0)
+#define QUEUE__SET_SIGNAL(q, cond) ((void)0)
+#define QUEUE__SET_DEFINE(name, type)
+#endif
+
+/*
+ * Residency tracing (QUEUE_ENABLE_TRACE=1).
+ *
+ * Queues from QUEUE_DEFINE and QUEUE_DEFINE_PADDED stamp every slot with
+ * QUEUE_TRACE_CLOCK() when it is published and, when the consumer takes it,
+ * add the enqueue-to-dequeue delta to a log-linear histogram: values below
+ * 2^QUEUE_TRACE_SUB_BITS get a bucket each, every power of two above is
+ * split into 2^QUEUE_TRACE_SUB_BITS buckets, so the relative error is at
+ * most 2^-QUEUE_TRACE_SUB_BITS over the whole 64-bit range. The clock unit
+ * is whatever the hook returns (cycles, ticks, ns). Only the consumer
+ * writes the histogram; `name##_trace_percentile(q, pct)` may be called
+ * from any thread and then reads a slightly stale snapshot. Items dropped
+ * by overwrite-on-full are not recorded.
+ */
+#ifndef QUEUE_TRACE_SUB_BITS
+#define QUEUE_TRACE_SUB_BITS 3U
+#endif
+
+#if QUEUE_ENABLE_TRACE
+#define QUEUE__TRACE_SUB   (1U << (QUEUE_TRACE_SUB_BITS))
+#define QUEUE__TRACE_BUCKETS                                                   \
+        ((65U - (QUEUE_TRACE_SUB_BITS)) << (QUEUE_TRACE_SUB_BITS))
+
+static inline unsigned
+queue__trace_bucket(uint64_t v)
+{
+        if (v < QUEUE__TRACE_SUB) {
+                return (unsigned)v;
+        }
+#if defined(__GNUC__)
+        const unsigned msb = 63U - (unsigned)__builtin_clzll(v);
+#else
+        unsigned msb = 0U;
+        for (uint64_t x = v >> 1; x != 0U; x >>= 1) {
+                msb++;
+        }
+#endif
+        const unsigned shift = msb - (QUEUE_TRACE_SUB_BITS);
+        return ((shift + 1U) << (QUEUE_TRACE_SUB_BITS)) +
+               (unsigned)((v >> shift) - QUEUE__TRACE_SUB);
+}
+
+/* Largest value that falls into bucket `b`. */
+static inline uint64_t
+queue__trace_bucket_max(unsigned b)
+{
+        if (b < QUEUE__TRACE_SUB) {
+                return b;
+        }
+        const unsigned shift = (b >> (QUEUE_TRACE_SUB_BITS)) - 1U;
+        const uint64_t mant = QUEUE__TRACE_SUB + (b & (QUEUE__TRACE_SUB - 1U));
+        return ((mant + 1U) << shift) - 1U;
+}
+
+static inline void
+queue__trace_record(queue__index_t *hist, uint64_t stamp)
+{
+        queue__index_t *slot =
+            &hist[queue__trace_bucket((uint64_t)QUEUE_TRACE_CLOCK() - stamp)];
+        queue__store_relaxed(slot, queue__load_relaxed(slot) + 1U);
+}
+
+static inline size_t
+queue__trace_count(const queue__index_t *hist)
+{
+        size_t total = 0U;
+        for (unsigned b = 0U; b < QUEUE__TRACE_BUCKETS; b++) {
+                total += queue__load_relaxed(&hist[b]);
+        }
+        return total;
+}
+
+static inline uint64_t
+queue__trace_percentile(const queue__index_t *hist, double pct)
+{
+        const size_t total = queue__trace_count(hist);
+        if (total == 0U) {
+                return 0U;
+        }
+        if (pct < 0.0) {
+                pct = 0.0;
+        } else if (pct > 100.0) {
+                pct = 100.0;
+        }
+        size_t rank = (size_t)(((double)total * pct) / 100.0);
+        if ((double)rank < ((double)total * pct) / 100.0) {
+                rank++;
+        }
+        if (rank == 0U) {
+                rank = 1U;
+        }
+        size_t seen = 0U;
+        unsigned last = 0U;
+        for (unsigned b = 0U; b < QUEUE__TRACE_BUCKETS; b++) {
+                const size_t n = queue__load_relaxed(&hist[b]);
+                if (n == 0U) {
+                        continue;
+                }
+                last = b;
+                seen += n;
+                if (seen >= rank) {
+                        break;
+                }
+        }
+        return queue__trace_bucket_max(last);
+}
+
+#define QUEUE__TRACE_FIELDS(ring_size)                                         \
+        uint64_t trace_stamp[ring_size];                                       \
+        queue__index_t trace_hist[QUEUE__TRACE_BUCKETS];
+
+#define QUEUE__TRACE_STAMP(q, index)                                           \
+        ((q)->trace_stamp[index] = (uint64_t)QUEUE_TRACE_CLOCK())
+
+#define QUEUE__TRACE_STAMP_N(q, index, n, ring_size)                           \
+        do {                                                                   \
+                const uint64_t trace_now = (uint64_t)QUEUE_TRACE_CLOCK();      \
+                size_t trace_i = (index);                                      \
+                for (size_t trace_k = 0U; trace_k < (n); trace_k++) {          \
+                        (q)->trace_stamp[trace_i] = trace_now;                 \
+                        trace_i = queue__next_index(trace_i, ring_size);       \
+                }                                                              \
+        } while (0)
+
+#define QUEUE__TRACE_RECORD(q, index)                                          \
+        queue__trace_record((q)->trace_hist, (q)->trace_stamp[index])
+
+#define QUEUE__TRACE_RECORD_N(q, index, n, ring_size)                          \
+        do {                                                                   \
+                size_t trace_i = (index);                                      \
+                for (size_t trace_k = 0U; trace_k < (n); trace_k++) {          \
+                        QUEUE__TRACE_RECORD(q, trace_i);                       \
+                        trace_i = queue__next_index(trace_i, ring_size);       \
+                }                                                              \
+        } while (0)
+
+#define QUEUE__TRACE_INIT(name, q) name##_trace_reset(q)
+
+#define QUEUE__TRACE_DEFINE(name)                                              \
+        static inline QUEUE__UNUSED void name##_trace_reset(name##_t *q)       \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                for (unsigned b = 0U; b < QUEUE__TRACE_BUCKETS; b++) {         \
+                        queue__store_relaxed(&q->trace_hist[b], 0U);           \
+                }                                                              \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_trace_count(                 \
+            const name##_t *q)                                                 \
+        {                                                                      \
+                return q ? queue__trace_count(q->trace_hist) : 0U;             \
+        }                                                                      \
+        static inline QUEUE__UNUSED uint64_t name##_trace_percentile(          \
+            const name##_t *q, double pct)                                     \
+        {                                                                      \
+                return q ? queue__trace_percentile(q->trace_hist, pct) : 0U;   \
+        }
+#else
+#define QUEUE__TRACE_FIELDS(ring_size)
+#define QUEUE__TRACE_STAMP(q, index) ((void)0)
+#define QUEUE__TRACE_STAMP_N(q, index, n, ring_size) ((void)0)
+#define QUEUE__TRACE_RECORD(q, index) ((void)0)
+#define QUEUE__TRACE_RECORD_N(q, index, n, ring_size) ((void)0)
+#define QUEUE__TRACE_INIT(name, q) ((void)0)
+#define QUEUE__TRACE_DEFINE(name)
+#endif
+/* Hook selectors: run-time sized queues pass UNTRACED. */
+#define QUEUE__TRACE_STAMP_TRACED(q, index) QUEUE__TRACE_STAMP(q, index)
+#define QUEUE__TRACE_STAMP_N_TRACED(q, index, n, ring_size)                    \
+        QUEUE__TRACE_STAMP_N(q, index, n, ring_size)
+#define QUEUE__TRACE_RECORD_TRACED(q, index) QUEUE__TRACE_RECORD(q, index)
+#define QUEUE__TRACE_RECORD_N_TRACED(q, index, n, ring_size)                   \
+        QUEUE__TRACE_RECORD_N(q, index, n, ring_size)
+#define QUEUE__TRACE_STAMP_UNTRACED(q, index) ((void)0)
+#define QUEUE__TRACE_STAMP_N_UNTRACED(q, index, n, ring_size) ((void)0)
+#define QUEUE__TRACE_RECORD_UNTRACED(q, index) ((void)0)
+#define QUEUE__TRACE_RECORD_N_UNTRACED(q, index, n, ring_size) ((void)0)
+
+/*
+ * Batching producer handle.
+ *
+ * `name##_producer_t` writes items into the ring but publishes `head` only
+ * every `batch` items, on `name##_flush(p)`, or when the ring looks full, so
+ * the consumer takes one coherence miss per burst instead of one per item.
+ * The handle keeps its own write position and cached `tail`; it is always
+ * fail-on-full and needs no critical section. While a handle is in use the
+ * producer must not call the other producer functions without flushing
+ * first.
+ */
+#define QUEUE__BATCH_DEFINE(name, type, capacity, layout, trace)               \
+        typedef struct {                                                       \
+                name##_t *q;                                                   \
+                size_t head;                                                   \
+                size_t tail;                                                   \
+                size_t pending;                                                \
+                size_t batch;                                                  \
+        } name##_producer_t;                                                   \
+        static inline QUEUE__UNUSED queue_status_t name##_producer_init(       \
+            name##_producer_t *p, name##_t *q, size_t batch)                   \
+        {                                                                      \
+                if (!p || !q) {                                                \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                p->q = q;                                                      \
+                p->head = queue__load_relaxed(&q->head);                       \
+                p->tail = queue__load_acquire(&q->tail);                       \
+                p->pending = 0U;                                               \
+                p->batch = (batch != 0U) ? batch : 1U;                         \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_flush(               \
+            name##_producer_t *p)                                              \
+        {                                                                      \
+                if (!p) {                                                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t n = p->pending;                                   \
+                if (n == 0U) {                                                 \
+                        return QUEUE_STATUS_OK;                                \
+                }                                                              \
+                name##_t *q = p->q;                                            \
+                QUEUE__SYNC_TAIL_CACHE_##layout(q, p->tail);                   \
+                queue__store_release(&q->head, p->head);                       \
+                p->pending = 0U;                                               \
+                QUEUE__STAT_PRODUCE(                                           \
+                    q, n, 0U, 0U,                                              \
+                    queue__ring_count(p->head, p->tail, (capacity) + 1U));     \
+                QUEUE__WAKE_CONSUMER(q, true);                                 \
+                QUEUE__NOTIFY(q, true);                                        \
+                QUEUE__SET_SIGNAL(q, true);                                    \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_producer_enqueue(    \
+            name##_producer_t *p, const type *item)                            \
+        {                                                                      \
+                if (!p || !item) {                                             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                name##_t *q = p->q;                                            \
+                const size_t ring_size = (capacity) + 1U;                      \
+                const size_t next_head =                                       \
+                    queue__next_index(p->head, ring_size);                     \
+                if (next_head == p->tail) {                                    \
+                        p->tail = queue__load_acquire(&q->tail);               \
+                        if (next_head == p->tail) {                            \
+                                (void)name##_flush(p);                         \
+                                QUEUE__STAT_PRODUCE(q, 0U, 0U, 1U,             \
+                                                    ring_size - 1U);           \
+                                return QUEUE_STATUS_FULL;                      \
+                        }                                                      \
+                }                                                              \
+                q->buffer[p->head] = *item;                                    \
+                QUEUE__TRACE_STAMP_##trace(q, p->head);                        \
+                p->head = next_head;                                           \
+                if ((++p->pending >= p->batch) ||                              \
+                    (queue__next_index(next_head, ring_size) == p->tail)) {    \
+                        (void)name##_flush(p);                                 \
+                }                                                              \
+                return QUEUE_STATUS_OK;                                        \
+        }
+
+/*
+ * Struct layouts.
+ *
+ * COMPACT: buffer followed by head/tail; smallest footprint, used by
+ * QUEUE_DEFINE.
+ * PADDED: head and tail on separate cache lines, each next to a side-local
+ * copy of the other index (producer: `tail_cache`, consumer: `head_cache`)
+ * that is only refreshed when the queue looks full/empty. Used by
+ * QUEUE_DEFINE_PADDED for cross-core SPSC. In overwrite mode the producer
+ * moves `tail`, so the cached copies are bypassed.
+ */
+#define QUEUE__FIELDS_COMPACT(type, ring_size)                                 \
+        type buffer[ring_size];                                                \
+        queue__index_t head;                                                   \
+        queue__index_t tail;
+
+#define QUEUE__FIELDS_PADDED(type, ring_size)                                  \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t head;             \
+        size_t tail_cache;                                                     \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t tail;             \
+        size_t head_cache;                                                     \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) type buffer[ring_size];
+
+#define QUEUE__RESET_CACHE_COMPACT(q) ((void)(q))
+#define QUEUE__RESET_CACHE_PADDED(q)                                           \
+        ((q)->tail_cache = 0U, (q)->head_cache = 0U)
+
+/*
+ * Bulk operations observe the live index and must then re-sync the cache so a
+ * later single-item operation never runs past it.
+ */
+#define QUEUE__SYNC_TAIL_CACHE_COMPACT(q, tail) ((void)(q), (void)(tail))
+#define QUEUE__SYNC_HEAD_CACHE_COMPACT(q, head) ((void)(q), (void)(head))
+#define QUEUE__SYNC_TAIL_CACHE_PADDED(q, tail) ((q)->tail_cache = (tail))
+#define QUEUE__SYNC_HEAD_CACHE_PADDED(q, head) ((q)->head_cache = (head))
+
+#define QUEUE__PRODUCER_TAIL_COMPACT(q, next_head)                             \
+        queue__load_acquire(&(q)->tail)
+#define QUEUE__CONSUMER_HEAD_COMPACT(q, tail) queue__load_acquire(&(q)->head)
+
+#if QUEUE_OVERWRITE_ON_FULL
+#define QUEUE__PRODUCER_TAIL_PADDED(q, next_head)                              \
+        QUEUE__PRODUCER_TAIL_COMPACT(q, next_head)
+#define QUEUE__CONSUMER_HEAD_PADDED(q, tail)                                   \
+        QUEUE__CONSUMER_HEAD_COMPACT(q, tail)
+#else
+#define QUEUE__PRODUCER_TAIL_PADDED(q, next_head)                              \
+        (((next_head) == (q)->tail_cache)                                      \
+             ? ((q)->tail_cache = queue__load_acquire(&(q)->tail))             \
+             : (q)->tail_cache)
+#define QUEUE__CONSUMER_HEAD_PADDED(q, tail)                                   \
+        (((tail) == (q)->head_cache)                                           \
+             ? ((q)->head_cache = queue__load_acquire(&(q)->head))             \
+             : (q)->head_cache)
+#endif
+
+/*
+ * QUEUE_DEFINE(name, type, capacity)
+ *
+ * Defines:
+ * - type: `name##_t`
+ * - functions: `name##_init`, `name##_enqueue`, `name##_dequeue`, ...
+ *
+ * `capacity` is the usable element capacity.
+ *
+ * Zero-copy access:
+ * - Producer: `name##_reserve` returns the next free slot (NULL if full),
+ *   `name##_commit` publishes it. `name##_reserve_span` returns the largest
+ *   contiguous free run before the wrap and its length; `name##_commit_n`
+ *   publishes `n` (<= length) slots of it (QUEUE_STATUS_BAD_ARG if `n`
+ *   exceeds the free space).
+ * - Consumer: `name##_peek` returns the oldest slot (NULL if empty),
+ *   `name##_release` frees it (QUEUE_STATUS_EMPTY if there is none).
+ *   `name##_consume(q, max, fn, ctx)` calls `fn(item, ctx)` in place on up
+ *   to `max` of the oldest slots, one contiguous run at a time, frees them
+ *   with a single `tail` store and returns how many it processed. The whole
+ *   drain is one critical section (bound `max` if that masks interrupts);
+ *   `fn` must not call consumer functions of the same queue.
+ * Reserve never overwrites, even in overwrite mode. In overwrite mode a
+ * regular enqueue on a full queue reclaims the peeked slot, so peek/release
+ * must not race with such an enqueue.
+ */
+#define QUEUE_DEFINE(name, type, capacity)                                     \
+        QUEUE__DEFINE_IMPL(name, type, capacity, COMPACT)
+
+/*
+ * QUEUE_DEFINE_PADDED(name, type, capacity)
+ *
+ * Same API as QUEUE_DEFINE, with head/tail on separate cache lines
+ * (QUEUE_CACHE_LINE_SIZE) and side-local cached indices. Use for queues whose
+ * producer and consumer run on different cores.
+ */
+#define QUEUE_DEFINE_PADDED(name, type, capacity)                              \
+        QUEUE__DEFINE_IMPL(name, type, capacity, PADDED)
+
+#define QUEUE__DEFINE_IMPL(name, type, capacity, layout)                       \
+        typedef struct {                                                       \
+                QUEUE__FIELDS_##layout(type, (capacity) + 1U)                  \
+                QUEUE__STATS_FIELDS_##layout                                   \
+                QUEUE__WAIT_FIELDS                                             \
+                QUEUE__NOTIFY_FIELDS                                           \
+                QUEUE__SET_FIELDS                                              \
+                QUEUE__TRACE_FIELDS((capacity) + 1U)                           \
+        } name##_t;                                                            \
+        QUEUE__STATS_DEFINE(name)                                              \
+        QUEUE__TRACE_DEFINE(name)                                              \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+                QUEUE__RESET_CACHE_##layout(q);                                \
+                QUEUE__STATS_INIT(name, q);                                    \
+                QUEUE__WAIT_RESET(q);                                          \
+                QUEUE__NOTIFY_RESET(q);                                        \
+                QUEUE__SET_RESET(q);                                           \
+                QUEUE__TRACE_INIT(name, q);                                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (capacity);                                             \
+        }                                                                      \
+        QUEUE__DEFINE_OPS(name, type, capacity, layout, TRACED)
+
+/*
+ * Functions shared by the fixed-size and the run-time sized queues.
+ * `capacity` is an expression for the usable capacity; it may read `q` and
+ * is only evaluated after `q` was checked. `trace` is TRACED or UNTRACED.
+ */
+#define QUEUE__DEFINE_OPS(name, type, capacity, layout, trace)                 \
+        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+                QUEUE__RESET_CACHE_##layout(q);                                \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return !q || (queue__load_acquire(&q->head) ==                 \
+                              queue__load_acquire(&q->tail));                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_full(const name##_t *q)     \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return false;                                          \
+                }                                                              \
+                const size_t ring_size = (capacity) + 1U;                      \
+                return queue__next_index(queue__load_acquire(&q->head),        \
+                                         ring_size) ==                         \
+                       queue__load_acquire(&q->tail);                          \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return 0;                                              \
+                }                                                              \
+                const size_t head = queue__load_acquire(&q->head);             \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                return queue__ring_count(head, tail, (capacity) + 1U);         \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const type *item)                                     \
+        {                                                                      \
+                if (!q || !item) {                                             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t ring_size = (capacity) + 1U;                      \
+                queue_status_t status = QUEUE_STATUS_OK;                       \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                size_t next_head = queue__next_index(head, ring_size);         \
+                const size_t tail =                                            \
+                    QUEUE__PRODUCER_TAIL_##layout(q, next_head);               \
+                if (next_head == tail) {                                       \
+                        QUEUE__HANDLE_FULL(q, ring_size, status);              \
+                }                                                              \
+                if (status != QUEUE_STATUS_FULL) {                             \
+                        q->buffer[head] = *item;                               \
+                        QUEUE__TRACE_STAMP_##trace(q, head);                   \
+                        queue__store_release(&q->head, next_head);             \
+                }                                                              \
+                QUEUE__STAT_PRODUCE(                                           \
+                    q, (status != QUEUE_STATUS_FULL) ? 1U : 0U,                \
+                    (status == QUEUE_STATUS_OVERWROTE) ? 1U : 0U,              \
+                    (status == QUEUE_STATUS_FULL) ? 1U : 0U,                   \
+                    (next_head == tail)                                        \
+                        ? (capacity)                                           \
+                        : queue__ring_count(next_head, tail, ring_size));      \
+                QUEUE_EXIT_CRITICAL();                                         \
+                QUEUE__WAKE_CONSUMER(q, status != QUEUE_STATUS_FULL);          \
+                QUEUE__NOTIFY(q, status != QUEUE_STATUS_FULL);                 \
+                QUEUE__SET_SIGNAL(q, status != QUEUE_STATUS_FULL);             \
+                return status;                                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(name##_t *q, \
+                                                                  type *out)   \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t ring_size = (capacity) + 1U;                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                if (QUEUE__CONSUMER_HEAD_##layout(q, tail) == tail) {          \
+                        QUEUE_EXIT_CRITICAL();                                 \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                *out = q->buffer[tail];                                        \
+                QUEUE__TRACE_RECORD_##trace(q, tail);                          \
+                queue__store_release(&q->tail,                                 \
+                                     queue__next_index(tail, ring_size));      \
+                QUEUE__STAT_CONSUME(q, 1U);                                    \
+                QUEUE_EXIT_CRITICAL();                                         \
+                QUEUE__WAKE_PRODUCER(q, true);                                 \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue_bulk(        \
+            name##_t *q, const type *items, size_t n, size_t *written)         \
+        {                                                                      \
+                if (!q || !items || !written) {                                \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t ring_size = (capacity) + 1U;                      \
+                queue_status_t status = QUEUE_STATUS_OK;                       \
+                size_t k = n;                                                  \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                const size_t used = queue__ring_count(head, tail, ring_size);  \
+                if (QUEUE_OVERWRITE_ON_FULL) {                                 \
+                        if (k > (capacity)) {                                  \
+                                items += k - (capacity);                       \
+                                k = (capacity);                                \
+                                status = QUEUE_STATUS_OVERWROTE;               \
+                        }                                                      \
+                        if (used + k > (capacity)) {                           \
+                                const size_t drop = used + k - (capacity);     \
+                                queue__store_release(                          \
+                                    &q->tail,                                  \
+                                    queue__ring_add(tail, drop, ring_size));   \
+                                status = QUEUE_STATUS_OVERWROTE;               \
+                        }                                                      \
+                        *written = n;                                          \
+                } else {                                                       \
+                        if (k > (capacity) - used) {                           \
+                                k = (capacity) - used;                         \
+                                status = QUEUE_STATUS_FULL;                    \
+                        }                                                      \
+                        *written = k;                                          \
+                }                                                              \
+                QUEUE__SYNC_TAIL_CACHE_##layout(q, tail);                      \
+                const size_t first =                                           \
+                    (k < ring_size - head) ? k : (ring_size - head);           \
+                memcpy(&q->buffer[head], items, first * sizeof(type));         \
+                memcpy(&q->buffer[0], items + first,                           \
+                       (k - first) * sizeof(type));                            \
+                QUEUE__TRACE_STAMP_N_##trace(q, head, k, ring_size);           \
+                queue__store_release(&q->head,                                 \
+                                     queue__ring_add(head, k, ring_size));     \
+                QUEUE__STAT_PRODUCE(                                           \
+                    q, *written,                                               \
+                    (QUEUE_OVERWRITE_ON_FULL && (used + n > (capacity)))       \
+                        ? (used + n - (capacity))                              \
+                        : 0U,                                                  \
+                    QUEUE_OVERWRITE_ON_FULL ? 0U : (n - k),                    \
+                    (used + k > (capacity)) ? (capacity) : (used + k));        \
+                QUEUE_EXIT_CRITICAL();                                         \
+                QUEUE__WAKE_CONSUMER(q, k != 0U);                              \
+                QUEUE__NOTIFY(q, k != 0U);                                     \
+                QUEUE__SET_SIGNAL(q, k != 0U);                                 \
+                return status;                                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue_bulk(        \
+            name##_t *q, type *out, size_t max, size_t *read)                  \
+        {                                                                      \
+                if (!q || !out || !read) {                                     \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t ring_size = (capacity) + 1U;                      \
+                *read = 0U;                                                    \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                const size_t head = queue__load_acquire(&q->head);             \
+                const size_t avail = queue__ring_count(head, tail, ring_size); \
+                if (avail == 0U) {                                             \
+                        QUEUE_EXIT_CRITICAL();                                 \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                QUEUE__SYNC_HEAD_CACHE_##layout(q, head);                      \
+                const size_t k = (max < avail) ? max : avail;                  \
+                const size_t first =                                           \
+                    (k < ring_size - tail) ? k : (ring_size - tail);           \
+                memcpy(out, &q->buffer[tail], first * sizeof(type));           \
+                memcpy(out + first, &q->buffer[0],                             \
+                       (k - first) * sizeof(type));                            \
+                QUEUE__TRACE_RECORD_N_##trace(q, tail, k, ring_size);          \
+                queue__store_release(&q->tail,                                 \
+                                     queue__ring_add(tail, k, ring_size));     \
+                QUEUE__STAT_CONSUME(q, k);                                     \
+                QUEUE_EXIT_CRITICAL();                                         \
+                QUEUE__WAKE_PRODUCER(q, true);                                 \
+                *read = k;                                                     \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_consume(                     \
+            name##_t *q, size_t max, void (*fn)(type *item, void *ctx),        \
+            void *ctx)                                                         \
+        {                                                                      \
+                if (!q || !fn) {                                               \
+                        return 0U;                                             \
+                }                                                              \
+                const size_t ring_size = (capacity) + 1U;                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                const size_t head = queue__load_acquire(&q->head);             \
+                const size_t avail = queue__ring_count(head, tail, ring_size); \
+                QUEUE__SYNC_HEAD_CACHE_##layout(q, head);                      \
+                const size_t k = (max < avail) ? max : avail;                  \
+                const size_t first =                                           \
+                    (k < ring_size - tail) ? k : (ring_size - tail);           \
+                QUEUE__TRACE_RECORD_N_##trace(q, tail, k, ring_size);          \
+                for (size_t i = 0U; i < first; i++) {                          \
+                        fn(&q->buffer[tail + i], ctx);                         \
+                }                                                              \
+                for (size_t i = 0U; i < k - first; i++) {                      \
+                        fn(&q->buffer[i], ctx);                                \
+                }                                                              \
+                if (k != 0U) {                                                 \
+                        queue__store_release(                                  \
+                            &q->tail, queue__ring_add(tail, k, ring_size));    \
+                        QUEUE__STAT_CONSUME(q, k);                             \
+                }                                                              \
+                QUEUE_EXIT_CRITICAL();                                         \
+                QUEUE__WAKE_PRODUCER(q, k != 0U);                              \
+                return k;                                                      \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_reserve(name##_t *q)          \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return NULL;                                           \
+                }                                                              \
+                type *slot = NULL;                                             \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                size_t next_head = queue__next_index(head, (capacity) + 1U);   \
+                if (next_head !=                                               \
+                    QUEUE__PRODUCER_TAIL_##layout(q, next_head)) {             \
+                        slot = &q->buffer[head];                               \
+                }                                                              \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return slot;                                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_reserve_span(name##_t *q,     \
+                                                              size_t *len)     \
+        {                                                                      \
+                if (!q || !len) {                                              \
+                        return NULL;                                           \
+                }                                                              \
+                const size_t ring_size = (capacity) + 1U;                      \
+                size_t n;                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                QUEUE__SYNC_TAIL_CACHE_##layout(q, tail);                      \
+                if (tail > head) {                                             \
+                        n = tail - head - 1U;                                  \
+                } else {                                                       \
+                        n = ring_size - head - ((tail == 0U) ? 1U : 0U);       \
+                }                                                              \
+                QUEUE_EXIT_CRITICAL();                                         \
+                *len = n;                                                      \
+                return (n != 0U) ? &q->buffer[head] : NULL;                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_commit_n(            \
+            name##_t *q, size_t n)                                             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                if (n > (capacity) - queue__ring_count(                        \
+                                         head, queue__load_acquire(&q->tail),  \
+                                         (capacity) + 1U)) {                   \
+                        QUEUE_EXIT_CRITICAL();                                 \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t next_head =                                       \
+                    queue__ring_add(head, n, (capacity) + 1U);                 \
+                QUEUE__TRACE_STAMP_N_##trace(q, head, n, (capacity) + 1U);     \
+                queue__store_release(&q->head, next_head);                     \
+                QUEUE__STAT_PRODUCE(                                           \
+                    q, n, 0U, 0U,                                              \
+                    queue__ring_count(next_head,                               \
+                                      queue__load_acquire(&q->tail),           \
+                                      (capacity) + 1U));                       \
+                QUEUE_EXIT_CRITICAL();                                         \
+                QUEUE__WAKE_CONSUMER(q, n != 0U);                              \
+                QUEUE__NOTIFY(q, n != 0U);                                     \
+                QUEUE__SET_SIGNAL(q, n != 0U);                                 \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_commit(name##_t *q)  \
+        {                                                                      \
+                return name##_commit_n(q, 1U);                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_peek(name##_t *q)             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return NULL;                                           \
+                }                                                              \
+                type *slot = NULL;                                             \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                if (QUEUE__CONSUMER_HEAD_##layout(q, tail) != tail) {          \
+                        slot = &q->buffer[tail];                               \
+                }                                                              \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return slot;                                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_release(name##_t *q) \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                if (QUEUE__CONSUMER_HEAD_##layout(q, tail) == tail) {          \
+                        QUEUE_EXIT_CRITICAL();                                 \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                QUEUE__TRACE_RECORD_##trace(q, tail);                          \
+                queue__store_release(                                          \
+                    &q->tail, queue__next_index(tail, (capacity) + 1U));       \
+                QUEUE__STAT_CONSUME(q, 1U);                                    \
+                QUEUE_EXIT_CRITICAL();                                         \
+                QUEUE__WAKE_PRODUCER(q, true);                                 \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        QUEUE__BATCH_DEFINE(name, type, capacity, layout, trace)               \
+        QUEUE__WAIT_DEFINE(name, type, capacity)                               \
+        QUEUE__NOTIFY_DEFINE(name)                                             \
+        QUEUE__SET_DEFINE(name, type)
+
+/*
+ * QUEUE_DEFINE_RUNTIME(name, type)
+ * QUEUE_DEFINE_RUNTIME_PADDED(name, type)
+ *
+ * Same API as QUEUE_DEFINE / QUEUE_DEFINE_PADDED, but the ring lives in
+ * caller-provided storage whose size is chosen at run time, and one set of
+ * functions serves every size. Initialise with
+ * `name##_init(q, storage, QUEUE_RUNTIME_SLOTS(capacity))`; `storage` must
+ * hold that many `type` elements (a static array, a linker section or a
+ * one-time allocation) and outlive the queue. `name##_capacity(q)` takes
+ * the queue.
+ */
+#define QUEUE_RUNTIME_SLOTS(capacity) ((capacity) + 1U)
+
+#define QUEUE_DEFINE_RUNTIME(name, type)                                       \
+        QUEUE__DEFINE_RUNTIME_IMPL(name, type, COMPACT)
+
+#define QUEUE_DEFINE_RUNTIME_PADDED(name, type)                                \
+        QUEUE__DEFINE_RUNTIME_IMPL(name, type, PADDED)
+
+/* Read-only geometry first, then the same index fields as the fixed layout. */
+#define QUEUE__RUNTIME_FIELDS_COMPACT(type)                                    \
+        type *buffer;                                                          \
+        size_t ring_size;                                                      \
+        queue__index_t head;                                                   \
+        queue__index_t tail;
+
+#define QUEUE__RUNTIME_FIELDS_PADDED(type)                                     \
+        type *buffer;                                                          \
+        size_t ring_size;                                                      \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t head;             \
+        size_t tail_cache;                                                     \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t tail;             \
+        size_t head_cache;
+
+#define QUEUE__DEFINE_RUNTIME_IMPL(name, type, layout)                         \
+        typedef struct {                                                       \
+                QUEUE__RUNTIME_FIELDS_##layout(type)                           \
+                QUEUE__STATS_FIELDS_##layout                                   \
+                QUEUE__WAIT_FIELDS                                             \
+                QUEUE__NOTIFY_FIELDS                                           \
+                QUEUE__SET_FIELDS                                              \
+        } name##_t;                                                            \
+        QUEUE__STATS_DEFINE(name)                                              \
+                                                                               \
+        static inline QUEUE__UNUSED queue_status_t name##_init(                \
+            name##_t *q, type *storage, size_t slots)                          \
+        {                                                                      \
+                if (!q || !storage || (slots < 2U)) {                          \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                q->buffer = storage;                                           \
+                q->ring_size = slots;                                          \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+                QUEUE__RESET_CACHE_##layout(q);                                \
+                QUEUE__STATS_INIT(name, q);                                    \
+                QUEUE__WAIT_RESET(q);                                          \
+                QUEUE__NOTIFY_RESET(q);                                        \
+                QUEUE__SET_RESET(q);                                           \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(const name##_t *q)  \
+        {                                                                      \
+                return q ? (q->ring_size - 1U) : 0U;                           \
+        }                                                                      \
+        QUEUE__DEFINE_OPS(name, type, (q->ring_size - 1U), layout, UNTRACED)
+
+/*
+ * Out-of-line core (src/queue.c, linked from libqueue).
+ *
+ * queue_core_t is a type-erased SPSC ring: element size, slot count and full
+ * policy are run-time fields, and every operation is a real function shared
+ * by all queues, copying elements with memcpy. The library and its users
+ * must agree on QUEUE_USE_C11_ATOMICS. The core itself takes no critical
+ * section; the QUEUE_DEFINE_OUTLINE wrappers take it in the caller's
+ * translation unit.
+ */
+typedef struct {
+        unsigned char *buffer;
+        size_t elem_size;
+        size_t ring_size;
+        bool overwrite;
+        queue__index_t head;
+        queue__index_t tail;
+} queue_core_t;
+
+queue_status_t queue_core_init(queue_core_t *q, void *storage,
+                               size_t elem_size, size_t slots, bool overwrite);
+void queue_core_clear(queue_core_t *q);
+bool queue_core_is_empty(const queue_core_t *q);
+bool queue_core_is_full(const queue_core_t *q);
+size_t queue_core_count(const queue_core_t *q);
+queue_status_t queue_core_enqueue(queue_core_t *q, const void *item);
+queue_status_t queue_core_dequeue(queue_core_t *q, void *out);
+queue_status_t queue_core_enqueue_bulk(queue_core_t *q, const void *items,
+                                       size_t n, size_t *written);
+queue_status_t queue_core_dequeue_bulk(queue_core_t *q, void *out, size_t max,
+                                       size_t *read);
+size_t queue_core_consume(queue_core_t *q, size_t max,
+                          void (*fn)(void *item, void *ctx), void *ctx);
+void *queue_core_reserve(queue_core_t *q);
+void *queue_core_reserve_span(queue_core_t *q, size_t *len);
+queue_status_t queue_core_commit_n(queue_core_t *q, size_t n);
+void *queue_core_peek(queue_core_t *q);
+queue_status_t queue_core_release(queue_core_t *q);
+
+#define QUEUE__CORE(q) ((q) ? &(q)->core : NULL)
+
+/*
+ * QUEUE_DEFINE_OUTLINE(name, type, capacity)
+ *
+ * Same API and storage as QUEUE_DEFINE, but every function is a thin typed
+ * forward to the shared queue_core_* code, so additional queues cost only a
+ * few bytes of glue each. Pick QUEUE_DEFINE for hot queues and this for
+ * cold ones (see the README for the size/speed numbers). Statistics, wait,
+ * notify and batching hooks are not available on these queues.
+ * `name##_consume` reaches the typed handler through a small trampoline.
+ */
+#define QUEUE_DEFINE_OUTLINE(name, type, capacity)                             \
+        typedef struct {                                                       \
+                queue_core_t core;                                             \
+                type buffer[(capacity) + 1U];                                  \
+        } name##_t;                                                            \
+        typedef struct {                                                       \
+                void (*fn)(type *item, void *ctx);                             \
+                void *ctx;                                                     \
+        } name##__consume_t;                                                   \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                if (q) {                                                       \
+                        (void)queue_core_init(&q->core, q->buffer,             \
+                                              sizeof(type), (capacity) + 1U,   \
+                                              QUEUE_OVERWRITE_ON_FULL);        \
+                }                                                              \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        {                                                                      \
+                queue_core_clear(QUEUE__CORE(q));                              \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return queue_core_is_empty(QUEUE__CORE(q));                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_full(const name##_t *q)     \
+        {                                                                      \
+                return queue_core_is_full(QUEUE__CORE(q));                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (capacity);                                             \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        {                                                                      \
+                return queue_core_count(QUEUE__CORE(q));                       \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const type *item)                                     \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const queue_status_t st =                                      \
+                    queue_core_enqueue(QUEUE__CORE(q), item);                  \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return st;                                                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(name##_t *q, \
+                                                                  type *out)   \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const queue_status_t st =                                      \
+                    queue_core_dequeue(QUEUE__CORE(q), out);                   \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return st;                                                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue_bulk(        \
+            name##_t *q, const type *items, size_t n, size_t *written)         \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const queue_status_t st = queue_core_enqueue_bulk(             \
+                    QUEUE__CORE(q), items, n, written);                        \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return st;                                                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue_bulk(        \
+            name##_t *q, type *out, size_t max, size_t *read)                  \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const queue_status_t st =                                      \
+                    queue_core_dequeue_bulk(QUEUE__CORE(q), out, max, read);   \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return st;                                                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##__consume_item(void *item,      \
+                                                              void *ctx)       \
+        {                                                                      \
+                const name##__consume_t *c = (const name##__consume_t *)ctx;   \
+                c->fn((type *)item, c->ctx);                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_consume(                     \
+            name##_t *q, size_t max, void (*fn)(type *item, void *ctx),        \
+            void *ctx)                                                         \
+        {                                                                      \
+                if (!fn) {                                                     \
+                        return 0U;                                             \
+                }                                                              \
+                name##__consume_t c = {fn, ctx};                               \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t k = queue_core_consume(                           \
+                    QUEUE__CORE(q), max, name##__consume_item, &c);            \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return k;                                                      \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_reserve(name##_t *q)          \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                type *slot = (type *)queue_core_reserve(QUEUE__CORE(q));       \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return slot;                                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_reserve_span(name##_t *q,     \
+                                                              size_t *len)     \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                type *slot =                                                   \
+                    (type *)queue_core_reserve_span(QUEUE__CORE(q), len);      \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return slot;                                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_commit_n(            \
+            name##_t *q, size_t n)                                             \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const queue_status_t st =                                      \
+                    queue_core_commit_n(QUEUE__CORE(q), n);                    \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return st;                                                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_commit(name##_t *q)  \
+        {                                                                      \
+                return name##_commit_n(q, 1U);                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_peek(name##_t *q)             \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                type *slot = (type *)queue_core_peek(QUEUE__CORE(q));          \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return slot;                                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_release(name##_t *q) \
+        {                                                                      \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const queue_status_t st = queue_core_release(QUEUE__CORE(q));  \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return st;                                                     \
+        }
+
+/*
+ * QUEUE_DEFINE_POW2(name, type, capacity)
+ *
+ * Core element API of QUEUE_DEFINE for a power-of-two `capacity`:
+ * `name##_init`, `name##_clear`, `name##_capacity`, `name##_count`,
+ * `name##_is_empty`, `name##_is_full`, `name##_enqueue`, `name##_dequeue`
+ * and, with QUEUE_ENABLE_STATS, `name##_stats`/`name##_stats_reset`. The
+ * bulk, zero-copy, consume, batching producer, wait, notify, set and trace
+ * extensions are not generated. head/tail are free-running counters
+ * (wrapping at SIZE_MAX + 1) and slots are selected by masking, so there is
+ * no sentinel slot, no wrap branch, and count/is_full are a single
+ * subtraction.
+ */
+#define QUEUE_DEFINE_POW2(name, type, capacity)                                \
+        QUEUE__STATIC_ASSERT(name,                                             \
+                             ((capacity) > 0U) &&                              \
+                                 (((capacity) & ((capacity) - 1U)) == 0U),     \
+                             "QUEUE_DEFINE_POW2 capacity must be a power of "  \
+                             "two");                                           \
+        typedef struct {                                                       \
+                type buffer[capacity];                                         \
+                queue__index_t head;                                           \
+                queue__index_t tail;                                           \
+                QUEUE__STATS_FIELDS_COMPACT                                    \
+        } name##_t;                                                            \
+        QUEUE__STATS_DEFINE(name)                                              \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+                QUEUE__STATS_INIT(name, q);                                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (capacity);                                             \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return 0;                                              \
+                }                                                              \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                return queue__load_acquire(&q->head) - tail;                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return name##_count(q) == 0U;                                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_full(const name##_t *q)     \
+        {                                                                      \
+                return q && (name##_count(q) == (capacity));                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const type *item)                                     \
+        {                                                                      \
+                if (!q || !item) {                                             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                queue_status_t status = QUEUE_STATUS_OK;                       \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t used = head - queue__load_acquire(&q->tail);      \
+                if (used == (capacity)) {                                      \
+                        QUEUE__HANDLE_FULL_POW2(q, status);                    \
+                }                                                              \
+                if (status != QUEUE_STATUS_FULL) {                             \
+                        q->buffer[head & ((capacity) - 1U)] = *item;           \
+                        queue__store_release(&q->head, head + 1U);             \
+                }                                                              \
+                QUEUE__STAT_PRODUCE(                                           \
+                    q, (status != QUEUE_STATUS_FULL) ? 1U : 0U,                \
+                    (status == QUEUE_STATUS_OVERWROTE) ? 1U : 0U,              \
+                    (status == QUEUE_STATUS_FULL) ? 1U : 0U,                   \
+                    (used == (capacity)) ? (capacity) : (used + 1U));          \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return status;                                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(name##_t *q, \
+                                                                  type *out)   \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                QUEUE_ENTER_CRITICAL();                                        \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                if (queue__load_acquire(&q->head) == tail) {                   \
+                        QUEUE_EXIT_CRITICAL();                                 \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                *out = q->buffer[tail & ((capacity) - 1U)];                    \
+                queue__store_release(&q->tail, tail + 1U);                     \
+                QUEUE__STAT_CONSUME(q, 1U);                                    \
+                QUEUE_EXIT_CRITICAL();                                         \
+                return QUEUE_STATUS_OK;                                        \
+        }
+
+/*
+ * QUEUE_DEFINE_OVERWRITE(name, type, capacity)
+ *
+ * Lock-free SPSC queue that always overwrites the oldest element when full,
+ * independent of QUEUE_OVERWRITE_ON_FULL and without critical sections.
+ * `capacity` must be a power of two.
+ *
+ * The producer never touches `tail`. Each slot carries a sequence word
+ * (`((pos + 1) << 1) | writing`) so the consumer can detect slots that were
+ * overwritten before or while it copied them; such items are skipped and
+ * counted in `*lost` (may be NULL) of `name##_dequeue`. As with any seqlock,
+ * the consumer's copy may race with a producer write; the copy is discarded
+ * when the sequence word changed, and `*out` is only valid on
+ * QUEUE_STATUS_OK. `name##_enqueue` returns QUEUE_STATUS_OVERWROTE when the
+ * queue was full as seen by the producer.
+ */
+#define QUEUE_DEFINE_OVERWRITE(name, type, capacity)                           \
+        QUEUE__STATIC_ASSERT(name,                                             \
+                             ((capacity) > 0U) &&                              \
+                                 (((capacity) & ((capacity) - 1U)) == 0U),     \
+                             "QUEUE_DEFINE_OVERWRITE capacity must be a "      \
+                             "power of two");                                  \
+        typedef struct {                                                       \
+                struct {                                                       \
+                        queue__index_t seq;                                    \
+                        type item;                                             \
+                } slots[capacity];                                             \
+                queue__index_t head;                                           \
+                queue__index_t tail;                                           \
+        } name##_t;                                                            \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                for (size_t i = 0; i < (capacity); i++) {                      \
+                        queue__store_relaxed(&q->slots[i].seq, 0U);            \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                name##_clear(q);                                               \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (capacity);                                             \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return 0;                                              \
+                }                                                              \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                const size_t used = queue__load_acquire(&q->head) - tail;      \
+                return (used > (capacity)) ? (capacity) : used;                \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return name##_count(q) == 0U;                                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_full(const name##_t *q)     \
+        {                                                                      \
+                return q && (name##_count(q) == (capacity));                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const type *item)                                     \
+        {                                                                      \
+                if (!q || !item) {                                             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t seq = (head + 1U) << 1;                           \
+                queue_status_t status = QUEUE_STATUS_OK;                       \
+                if (head - queue__load_acquire(&q->tail) >= (capacity)) {      \
+                        status = QUEUE_STATUS_OVERWROTE;                       \
+                }                                                              \
+                queue__store_relaxed(&q->slots[head & ((capacity) - 1U)].seq,  \
+                                     seq | 1U);                                \
+                queue__fence_release();                                        \
+                q->slots[head & ((capacity) - 1U)].item = *item;               \
+                queue__store_release(&q->slots[head & ((capacity) - 1U)].seq,  \
+                                     seq);                                     \
+                queue__store_release(&q->head, head + 1U);                     \
+                return status;                                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(             \
+            name##_t *q, type *out, size_t *lost)                              \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                size_t tail = queue__load_relaxed(&q->tail);                   \
+                size_t skipped = 0U;                                           \
+                queue_status_t status = QUEUE_STATUS_EMPTY;                    \
+                for (;;) {                                                     \
+                        const size_t head = queue__load_acquire(&q->head);     \
+                        if (head == tail) {                                    \
+                                break;                                         \
+                        }                                                      \
+                        if (head - tail > (capacity)) {                        \
+                                skipped += head - tail - (capacity);           \
+                                tail = head - (capacity);                      \
+                        }                                                      \
+                        const size_t idx = tail & ((capacity) - 1U);           \
+                        const size_t seq = (tail + 1U) << 1;                   \
+                        if (queue__load_acquire(&q->slots[idx].seq) != seq) {  \
+                                skipped++;                                     \
+                                tail++;                                        \
+                                continue;                                      \
+                        }                                                      \
+                        *out = q->slots[idx].item;                             \
+                        queue__fence_acquire();                                \
+                        if (queue__load_relaxed(&q->slots[idx].seq) != seq) {  \
+                                skipped++;                                     \
+                                tail++;                                        \
+                                continue;                                      \
+                        }                                                      \
+                        tail++;                                                \
+                        status = QUEUE_STATUS_OK;                              \
+                        break;                                                 \
+                }                                                              \
+                queue__store_release(&q->tail, tail);                          \
+                if (lost) {                                                    \
+                        *lost = skipped;                                       \
+                }                                                              \
+                return status;                                                 \
         }
 
-/* Generic clear macro for queues generated by QUEUE_DEFINE */
+/* Generic clear macro for queues generated by QUEUE_DEFINE* */
 #define QUEUE_CLEAR(name, q)                                                   \
         do {                                                                   \
                 if ((void *)(q) != NULL) {                                     \
-                        (q)->head = 0U;                                        \
-                        (q)->tail = 0U;                                        \
+                        name##_clear(q);                                       \
                 }                                                              \
         } while (0)
 
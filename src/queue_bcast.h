@@ -0,0 +1,218 @@
+/*
+ * queue_bcast.h
+ *
+ * Single-producer broadcast ring (SPMC fan-out) built on queue.h:
+ * QUEUE_DEFINE_BCAST(name, type, capacity, consumers).
+ *
+ * - The producer writes each element once; every attached consumer reads it
+ *   through its own cursor, so producer work and memory are O(1) per item
+ *   instead of one queue per consumer.
+ * - `capacity` must be a power of two; positions are free-running.
+ * - Consumers are numbered 0 .. `consumers` - 1; each cursor lives on its
+ *   own cache line and is written only by its consumer.
+ * - QUEUE_OVERWRITE_ON_FULL=0: the producer never passes the slowest
+ *   attached consumer (QUEUE_STATUS_FULL). It keeps a private copy of the
+ *   minimum cursor (`gate`) and rescans the cursors only when that copy says
+ *   the ring is full.
+ * - QUEUE_OVERWRITE_ON_FULL=1: the producer never waits and laps slow
+ *   consumers. Slots carry a sequence word as in QUEUE_DEFINE_OVERWRITE; a
+ *   lapped consumer skips to the oldest surviving item and learns how many
+ *   it lost from `name##_dequeue`. No critical sections are needed.
+ */
+
+#ifndef QUEUE_BCAST_H
+#define QUEUE_BCAST_H
+
+#include "queue.h"
+
+/*
+ * QUEUE_DEFINE_BCAST(name, type, capacity, consumers)
+ *
+ * - name##_attach(q, id) / name##_detach(q, id): start reading at the
+ *   current head / stop gating the producer. Attach while the producer is
+ *   stopped (or before it starts); detach at any time.
+ * - name##_enqueue(q, item): producer only. In overwrite mode returns
+ *   QUEUE_STATUS_OVERWROTE when an attached consumer was lapped.
+ * - name##_dequeue(q, id, out, &lost): consumer `id` only. `lost` (may be
+ *   NULL) receives the number of items skipped since the previous call;
+ *   always 0 in fail-on-full mode.
+ */
+#define QUEUE_DEFINE_BCAST(name, type, capacity, consumers)                    \
+        QUEUE__STATIC_ASSERT(name,                                             \
+                             ((capacity) > 0U) &&                              \
+                                 (((capacity) & ((capacity) - 1U)) == 0U),     \
+                             "broadcast queue capacity must be a power of "    \
+                             "two");                                           \
+        QUEUE__STATIC_ASSERT(name##_readers, (consumers) > 0U,                 \
+                             "broadcast queue needs at least one consumer");   \
+        typedef struct {                                                       \
+                struct {                                                       \
+                        queue__index_t seq;                                    \
+                        type item;                                             \
+                } slots[capacity];                                             \
+                QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t head;     \
+                size_t gate;                                                   \
+                struct {                                                       \
+                        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE)                  \
+                        queue__index_t cursor;                                 \
+                        queue__index_t active;                                 \
+                } readers[consumers];                                          \
+        } name##_t;                                                            \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                for (size_t i = 0; i < (capacity); i++) {                      \
+                        queue__store_relaxed(&q->slots[i].seq, 0U);            \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                q->gate = 0U;                                                  \
+                for (size_t i = 0; i < (consumers); i++) {                     \
+                        queue__store_relaxed(&q->readers[i].cursor, 0U);       \
+                        queue__store_relaxed(&q->readers[i].active, 0U);       \
+                }                                                              \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (capacity);                                             \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_consumers(void)              \
+        {                                                                      \
+                return (consumers);                                            \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_attach(name##_t *q,  \
+                                                                 size_t id)    \
+        {                                                                      \
+                if (!q || (id >= (consumers))) {                               \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                queue__store_relaxed(&q->readers[id].cursor,                   \
+                                     queue__load_acquire(&q->head));           \
+                queue__store_release(&q->readers[id].active, 1U);              \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_detach(name##_t *q,  \
+                                                                 size_t id)    \
+        {                                                                      \
+                if (!q || (id >= (consumers))) {                               \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                queue__store_release(&q->readers[id].active, 0U);              \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q,     \
+                                                        size_t id)             \
+        {                                                                      \
+                if (!q || (id >= (consumers))) {                               \
+                        return 0U;                                             \
+                }                                                              \
+                const size_t cursor =                                          \
+                    queue__load_acquire(&q->readers[id].cursor);               \
+                const size_t used = queue__load_acquire(&q->head) - cursor;    \
+                return (used > (capacity)) ? (capacity) : used;                \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q,    \
+                                                         size_t id)            \
+        {                                                                      \
+                return name##_count(q, id) == 0U;                              \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##__min_cursor(                 \
+            const name##_t *q, size_t head)                                    \
+        {                                                                      \
+                size_t lag = 0U;                                               \
+                for (size_t i = 0; i < (consumers); i++) {                     \
+                        if (queue__load_acquire(&q->readers[i].active) ==      \
+                            0U) {                                              \
+                                continue;                                      \
+                        }                                                      \
+                        const size_t d =                                       \
+                            head -                                             \
+                            queue__load_acquire(&q->readers[i].cursor);        \
+                        if (d > lag) {                                         \
+                                lag = d;                                       \
+                        }                                                      \
+                }                                                              \
+                return head - lag;                                             \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const type *item)                                     \
+        {                                                                      \
+                if (!q || !item) {                                             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t idx = head & ((capacity) - 1U);                   \
+                queue_status_t status = QUEUE_STATUS_OK;                       \
+                if (head - q->gate >= (capacity)) {                            \
+                        q->gate = name##__min_cursor(q, head);                 \
+                        if (head - q->gate >= (capacity)) {                    \
+                                if (!QUEUE_OVERWRITE_ON_FULL) {                \
+                                        return QUEUE_STATUS_FULL;              \
+                                }                                              \
+                                status = QUEUE_STATUS_OVERWROTE;               \
+                        }                                                      \
+                }                                                              \
+                if (QUEUE_OVERWRITE_ON_FULL) {                                 \
+                        queue__store_relaxed(&q->slots[idx].seq,               \
+                                             ((head + 1U) << 1) | 1U);         \
+                        queue__fence_release();                                \
+                }                                                              \
+                q->slots[idx].item = *item;                                    \
+                if (QUEUE_OVERWRITE_ON_FULL) {                                 \
+                        queue__store_release(&q->slots[idx].seq,               \
+                                             (head + 1U) << 1);                \
+                }                                                              \
+                queue__store_release(&q->head, head + 1U);                     \
+                return status;                                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(             \
+            name##_t *q, size_t id, type *out, size_t *lost)                   \
+        {                                                                      \
+                if (!q || !out || (id >= (consumers))) {                       \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                queue__index_t *cur = &q->readers[id].cursor;                  \
+                size_t cursor = queue__load_relaxed(cur);                      \
+                size_t skipped = 0U;                                           \
+                queue_status_t status = QUEUE_STATUS_EMPTY;                    \
+                for (;;) {                                                     \
+                        const size_t head = queue__load_acquire(&q->head);     \
+                        if (head == cursor) {                                  \
+                                break;                                         \
+                        }                                                      \
+                        const size_t idx = cursor & ((capacity) - 1U);         \
+                        if (!QUEUE_OVERWRITE_ON_FULL) {                        \
+                                *out = q->slots[idx].item;                     \
+                                cursor++;                                      \
+                                status = QUEUE_STATUS_OK;                      \
+                                break;                                         \
+                        }                                                      \
+                        if (head - cursor > (capacity)) {                      \
+                                skipped += head - cursor - (capacity);         \
+                                cursor = head - (capacity);                    \
+                                continue;                                      \
+                        }                                                      \
+                        const size_t seq = (cursor + 1U) << 1;                 \
+                        if (queue__load_acquire(&q->slots[idx].seq) == seq) {  \
+                                *out = q->slots[idx].item;                     \
+                                queue__fence_acquire();                        \
+                                if (queue__load_relaxed(&q->slots[idx].seq) == \
+                                    seq) {                                     \
+                                        cursor++;                              \
+                                        status = QUEUE_STATUS_OK;              \
+                                        break;                                 \
+                                }                                              \
+                        }                                                      \
+                        skipped++;                                             \
+                        cursor++;                                              \
+                }                                                              \
+                queue__store_release(cur, cursor);                             \
+                if (lost) {                                                    \
+                        *lost = skipped;                                       \
+                }                                                              \
+                return status;                                                 \
+        }
+
+#endif /* QUEUE_BCAST_H */
@@ -0,0 +1,147 @@
+/*
+ * queue_conflate.h
+ *
+ * Keyed conflating (latest-value) SPSC queue built on queue.h:
+ * QUEUE_DEFINE_CONFLATE(name, type, keys).
+ *
+ * - Every element carries a key in 0 .. `keys` - 1. Each key owns one value
+ *   slot; an update for a key that is already pending overwrites that slot
+ *   in place instead of taking a new one, so the consumer sees at most one
+ *   item per key and its work is bounded by the number of distinct keys,
+ *   not by the update rate.
+ * - Keys are delivered in the order they first became pending.
+ * - The value slots are seqlocks (as in QUEUE_DEFINE_OVERWRITE), and
+ *   neither side waits for the other. The consumer clears a key's pending
+ *   flag before reading its slot; if the slot is mid-update or changes
+ *   during the copy, it skips the key, because the producer sees the
+ *   cleared flag when that update completes and queues the key again. A
+ *   per-key version lets the consumer drop a key whose value it has already
+ *   delivered.
+ * - A small ring of pending keys orders delivery; it holds at most `keys`
+ *   entries and never fills. QUEUE_OVERWRITE_ON_FULL does not apply.
+ * - Requires the C11 atomics backend (QUEUE_USE_C11_ATOMICS=1).
+ */
+
+#ifndef QUEUE_CONFLATE_H
+#define QUEUE_CONFLATE_H
+
+#include "queue.h"
+
+#if !QUEUE_USE_C11_ATOMICS
+#error "queue_conflate.h requires QUEUE_USE_C11_ATOMICS=1"
+#endif
+
+/*
+ * QUEUE_DEFINE_CONFLATE(name, type, keys)
+ *
+ * - name##_update(q, key, item): producer only. Returns QUEUE_STATUS_OK when
+ *   the key became pending, QUEUE_STATUS_OVERWROTE when a pending value for
+ *   the key was replaced.
+ * - name##_dequeue(q, out, &key): consumer only. Latest value of the oldest
+ *   pending key; `key` may be NULL.
+ * - name##_count(q): number of pending keys.
+ */
+#define QUEUE_DEFINE_CONFLATE(name, type, keys)                                \
+        QUEUE__STATIC_ASSERT(name, (keys) > 0U,                                \
+                             "conflating queue needs at least one key");       \
+        typedef struct {                                                       \
+                struct {                                                       \
+                        queue__index_t seq;                                    \
+                        queue__index_t pending;                                \
+                        type item;                                             \
+                } slots[keys];                                                 \
+                unsigned order[(keys) + 1U];                                   \
+                QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t head;     \
+                QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t tail;     \
+                size_t delivered[keys];                                        \
+        } name##_t;                                                            \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                for (size_t i = 0; i < (keys); i++) {                          \
+                        queue__store_relaxed(&q->slots[i].seq, 0U);            \
+                        queue__store_relaxed(&q->slots[i].pending, 0U);        \
+                        q->delivered[i] = 0U;                                  \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_keys(void)                   \
+        {                                                                      \
+                return (keys);                                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return 0U;                                             \
+                }                                                              \
+                const size_t head = queue__load_acquire(&q->head);             \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                return queue__ring_count(head, tail, (keys) + 1U);             \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return name##_count(q) == 0U;                                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_update(              \
+            name##_t *q, unsigned key, const type *item)                       \
+        {                                                                      \
+                if (!q || !item || (key >= (keys))) {                          \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                queue__index_t *seq = &q->slots[key].seq;                      \
+                const size_t s = queue__load_relaxed(seq);                     \
+                queue__store_relaxed(seq, s + 1U);                             \
+                queue__fence_release();                                        \
+                q->slots[key].item = *item;                                    \
+                queue__store_release(seq, s + 2U);                             \
+                atomic_thread_fence(memory_order_seq_cst);                     \
+                if (queue__load_relaxed(&q->slots[key].pending) != 0U) {       \
+                        return QUEUE_STATUS_OVERWROTE;                         \
+                }                                                              \
+                queue__store_relaxed(&q->slots[key].pending, 1U);              \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                q->order[head] = key;                                          \
+                queue__store_release(&q->head,                                 \
+                                     queue__next_index(head, (keys) + 1U));    \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(             \
+            name##_t *q, type *out, unsigned *key)                             \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                for (;;) {                                                     \
+                        const size_t tail = queue__load_relaxed(&q->tail);     \
+                        if (queue__load_acquire(&q->head) == tail) {           \
+                                return QUEUE_STATUS_EMPTY;                     \
+                        }                                                      \
+                        const unsigned k = q->order[tail];                     \
+                        queue__store_release(                                  \
+                            &q->tail, queue__next_index(tail, (keys) + 1U));   \
+                        queue__store_relaxed(&q->slots[k].pending, 0U);        \
+                        atomic_thread_fence(memory_order_seq_cst);             \
+                        const size_t s =                                       \
+                            queue__load_acquire(&q->slots[k].seq);             \
+                        if (((s & 1U) != 0U) || (s == q->delivered[k])) {      \
+                                continue;                                      \
+                        }                                                      \
+                        const type item = q->slots[k].item;                    \
+                        queue__fence_acquire();                                \
+                        if (queue__load_relaxed(&q->slots[k].seq) != s) {      \
+                                continue;                                      \
+                        }                                                      \
+                        q->delivered[k] = s;                                   \
+                        *out = item;                                           \
+                        if (key) {                                             \
+                                *key = k;                                      \
+                        }                                                      \
+                        return QUEUE_STATUS_OK;                                \
+                }                                                              \
+        }
+
+#endif /* QUEUE_CONFLATE_H */
@@ -0,0 +1,205 @@
+/*
+ * queue_mp.h
+ *
+ * Bounded multi-producer typed ring-buffer queues built on queue.h:
+ * QUEUE_DEFINE_MPSC (many producers, one consumer) and QUEUE_DEFINE_MPMC
+ * (many producers, many consumers).
+ *
+ * - No dynamic allocation: storage is embedded in the queue instance.
+ * - `capacity` must be a power of two and at least 2: with one slot the
+ *   "free again" sequence `pos + capacity` would equal the "published"
+ *   sequence `pos + 1`.
+ * - Always fail-on-full (QUEUE_STATUS_FULL); QUEUE_OVERWRITE_ON_FULL does not
+ *   apply.
+ *
+ * Each slot carries a sequence counter (D. Vyukov's bounded queue): a slot at
+ * position `pos` is free for the producer when `seq == pos` and holds an
+ * element for the consumer when `seq == pos + 1`. Producers claim positions
+ * with a CAS on `head`, so no lock or critical section is needed. Requires
+ * the C11 atomics backend (QUEUE_USE_C11_ATOMICS=1).
+ */
+
+#ifndef QUEUE_MP_H
+#define QUEUE_MP_H
+
+#include "queue.h"
+#include <stdint.h>
+
+#if !QUEUE_USE_C11_ATOMICS
+#error "queue_mp.h requires QUEUE_USE_C11_ATOMICS=1"
+#endif
+
+static inline bool
+queue__cas_weak(queue__index_t *p, size_t *expected, size_t desired)
+{
+        return atomic_compare_exchange_weak_explicit(
+            p, expected, desired, memory_order_relaxed, memory_order_relaxed);
+}
+
+/* Signed distance `a - b` between two free-running positions. */
+static inline intptr_t
+queue__pos_diff(size_t a, size_t b)
+{
+        return (intptr_t)(a - b);
+}
+
+#define QUEUE__MP_FIELDS(type, capacity)                                       \
+        struct {                                                               \
+                queue__index_t seq;                                            \
+                type item;                                                     \
+        } slots[capacity];                                                     \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t head;             \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t tail;
+
+/*
+ * Common part of the multi-producer queues: storage, init/clear, count and a
+ * lock-free multi-producer enqueue.
+ */
+#define QUEUE__MP_DEFINE_COMMON(name, type, capacity)                          \
+        QUEUE__STATIC_ASSERT(name,                                             \
+                             ((capacity) >= 2U) &&                             \
+                                 (((capacity) & ((capacity) - 1U)) == 0U),     \
+                             "multi-producer queue capacity must be a power "  \
+                             "of two >= 2");                                   \
+        typedef struct {                                                       \
+                QUEUE__MP_FIELDS(type, capacity)                               \
+        } name##_t;                                                            \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                for (size_t i = 0; i < (capacity); i++) {                      \
+                        queue__store_relaxed(&q->slots[i].seq, i);             \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                name##_clear(q);                                               \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (capacity);                                             \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return 0;                                              \
+                }                                                              \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                const intptr_t used =                                          \
+                    queue__pos_diff(queue__load_acquire(&q->head), tail);      \
+                if (used <= 0) {                                               \
+                        return 0U;                                             \
+                }                                                              \
+                return ((size_t)used > (capacity)) ? (capacity)                \
+                                                   : (size_t)used;             \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return name##_count(q) == 0U;                                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_full(const name##_t *q)     \
+        {                                                                      \
+                return q && (name##_count(q) == (capacity));                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const type *item)                                     \
+        {                                                                      \
+                if (!q || !item) {                                             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                size_t pos = queue__load_relaxed(&q->head);                    \
+                for (;;) {                                                     \
+                        const size_t seq = queue__load_acquire(                \
+                            &q->slots[pos & ((capacity) - 1U)].seq);           \
+                        const intptr_t diff = queue__pos_diff(seq, pos);       \
+                        if (diff == 0) {                                       \
+                                if (queue__cas_weak(&q->head, &pos,            \
+                                                    pos + 1U)) {               \
+                                        break;                                 \
+                                }                                              \
+                        } else if (diff < 0) {                                 \
+                                return QUEUE_STATUS_FULL;                      \
+                        } else {                                               \
+                                pos = queue__load_relaxed(&q->head);           \
+                        }                                                      \
+                }                                                              \
+                q->slots[pos & ((capacity) - 1U)].item = *item;                \
+                queue__store_release(&q->slots[pos & ((capacity) - 1U)].seq,   \
+                                     pos + 1U);                                \
+                return QUEUE_STATUS_OK;                                        \
+        }
+
+/*
+ * QUEUE_DEFINE_MPSC(name, type, capacity)
+ *
+ * Multi-producer / single-consumer queue with the same API and status codes
+ * as QUEUE_DEFINE (`name##_init`, `name##_enqueue`, `name##_dequeue`, ...).
+ * `name##_enqueue` may be called concurrently from any number of threads or
+ * ISRs; `name##_dequeue` from one consumer only. A producer that is
+ * preempted between claiming and publishing a slot delays the consumer
+ * (dequeue reports QUEUE_STATUS_EMPTY) until it resumes.
+ */
+#define QUEUE_DEFINE_MPSC(name, type, capacity)                                \
+        QUEUE__MP_DEFINE_COMMON(name, type, capacity)                          \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(name##_t *q, \
+                                                                  type *out)   \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t pos = queue__load_relaxed(&q->tail);              \
+                const size_t idx = pos & ((capacity) - 1U);                    \
+                if (queue__load_acquire(&q->slots[idx].seq) != pos + 1U) {     \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                *out = q->slots[idx].item;                                     \
+                queue__store_release(&q->slots[idx].seq, pos + (capacity));    \
+                queue__store_relaxed(&q->tail, pos + 1U);                      \
+                return QUEUE_STATUS_OK;                                        \
+        }
+
+/*
+ * QUEUE_DEFINE_MPMC(name, type, capacity)
+ *
+ * Multi-producer / multi-consumer queue with the same API and status codes
+ * as QUEUE_DEFINE. Both `name##_enqueue` and `name##_dequeue` may be called
+ * concurrently from any number of threads; consumers claim positions with a
+ * CAS on `tail`. `head` and `tail` live on separate cache lines, so
+ * producers and consumers only contend among themselves.
+ */
+#define QUEUE_DEFINE_MPMC(name, type, capacity)                                \
+        QUEUE__MP_DEFINE_COMMON(name, type, capacity)                          \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(name##_t *q, \
+                                                                  type *out)   \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                size_t pos = queue__load_relaxed(&q->tail);                    \
+                for (;;) {                                                     \
+                        const size_t seq = queue__load_acquire(                \
+                            &q->slots[pos & ((capacity) - 1U)].seq);           \
+                        const intptr_t diff = queue__pos_diff(seq, pos + 1U);  \
+                        if (diff == 0) {                                       \
+                                if (queue__cas_weak(&q->tail, &pos,            \
+                                                    pos + 1U)) {               \
+                                        break;                                 \
+                                }                                              \
+                        } else if (diff < 0) {                                 \
+                                return QUEUE_STATUS_EMPTY;                     \
+                        } else {                                               \
+                                pos = queue__load_relaxed(&q->tail);           \
+                        }                                                      \
+                }                                                              \
+                *out = q->slots[pos & ((capacity) - 1U)].item;                 \
+                queue__store_release(&q->slots[pos & ((capacity) - 1U)].seq,   \
+                                     pos + (capacity));                        \
+                return QUEUE_STATUS_OK;                                        \
+        }
+
+#endif /* QUEUE_MP_H */
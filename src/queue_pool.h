@@ -0,0 +1,137 @@
+/*
+ * queue_pool.h
+ *
+ * Fixed-block object pool paired with an SPSC handle queue, built on
+ * queue.h: QUEUE_DEFINE_POOL(name, type, blocks).
+ *
+ * - `blocks` elements of `type` are embedded in the instance; no dynamic
+ *   allocation.
+ * - Messages travel as 32-bit handles (block indices), so sending a
+ *   multi-kilobyte frame costs one index move regardless of its size.
+ * - Ownership moves with the handle: the producer allocates a block, fills
+ *   it and sends it; the consumer receives it, uses it in place and frees
+ *   it. A block is owned by exactly one side at a time and must not be
+ *   touched after it was sent/freed.
+ * - The free list is a second QUEUE_DEFINE_PADDED ring of handles running
+ *   in the opposite direction (consumer -> producer), so alloc and free are
+ *   lock-free for the SPSC pair without CAS or ABA tags. Both rings hold
+ *   `blocks` handles and can never fill, so QUEUE_OVERWRITE_ON_FULL never
+ *   drops a handle. Blocks the producer allocated but does not send go back
+ *   through `name##_discard` to a producer-private stack.
+ * - The release store that publishes a handle also publishes the block
+ *   contents written before it (and the acquire load on the other side
+ *   makes them visible), in both directions.
+ */
+
+#ifndef QUEUE_POOL_H
+#define QUEUE_POOL_H
+
+#include "queue.h"
+#include <stdint.h>
+
+typedef uint32_t queue_handle_t;
+
+/*
+ * QUEUE_DEFINE_POOL(name, type, blocks)
+ *
+ * Producer: name##_alloc(q, &h) returns a free block (NULL if all blocks
+ * are in use), name##_send(q, h) passes it to the consumer,
+ * name##_discard(q, h) returns an unsent block.
+ * Consumer: name##_receive(q, &h) returns the oldest sent block (NULL if
+ * none), name##_free(q, h) gives it back to the producer.
+ * name##_block(q, h) maps a handle to its block.
+ */
+#define QUEUE_DEFINE_POOL(name, type, blocks)                                  \
+        QUEUE__STATIC_ASSERT(name,                                             \
+                             ((blocks) > 0U) && ((blocks) <= UINT32_MAX),      \
+                             "pool needs 1 to UINT32_MAX blocks");             \
+        QUEUE_DEFINE_PADDED(name##_ring, queue_handle_t, blocks)               \
+                                                                               \
+        typedef struct {                                                       \
+                QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) type block[blocks];      \
+                name##_ring_t sent;                                            \
+                name##_ring_t freed;                                           \
+                size_t spare_count;                                            \
+                queue_handle_t spare[blocks];                                  \
+        } name##_t;                                                            \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                name##_ring_init(&q->sent);                                    \
+                name##_ring_init(&q->freed);                                   \
+                for (size_t i = 0; i < (blocks); i++) {                        \
+                        q->spare[i] = (queue_handle_t)((blocks) - 1U - i);     \
+                }                                                              \
+                q->spare_count = (blocks);                                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_blocks(void)                 \
+        {                                                                      \
+                return (blocks);                                               \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_block(name##_t *q,            \
+                                                       queue_handle_t h)       \
+        {                                                                      \
+                if (!q || (h >= (blocks))) {                                   \
+                        return NULL;                                           \
+                }                                                              \
+                return &q->block[h];                                           \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_alloc(name##_t *q,            \
+                                                       queue_handle_t *h)      \
+        {                                                                      \
+                if (!q || !h) {                                                \
+                        return NULL;                                           \
+                }                                                              \
+                if (q->spare_count != 0U) {                                    \
+                        *h = q->spare[--q->spare_count];                       \
+                } else if (name##_ring_dequeue(&q->freed, h) !=                \
+                           QUEUE_STATUS_OK) {                                  \
+                        return NULL;                                           \
+                }                                                              \
+                return &q->block[*h];                                          \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_discard(             \
+            name##_t *q, queue_handle_t h)                                     \
+        {                                                                      \
+                if (!q || (h >= (blocks)) || (q->spare_count >= (blocks))) {   \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                q->spare[q->spare_count++] = h;                                \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_send(                \
+            name##_t *q, queue_handle_t h)                                     \
+        {                                                                      \
+                if (!q || (h >= (blocks))) {                                   \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                return name##_ring_enqueue(&q->sent, &h);                      \
+        }                                                                      \
+        static inline QUEUE__UNUSED type *name##_receive(name##_t *q,          \
+                                                         queue_handle_t *h)    \
+        {                                                                      \
+                if (!q || !h) {                                                \
+                        return NULL;                                           \
+                }                                                              \
+                if (name##_ring_dequeue(&q->sent, h) != QUEUE_STATUS_OK) {     \
+                        return NULL;                                           \
+                }                                                              \
+                return &q->block[*h];                                          \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_free(                \
+            name##_t *q, queue_handle_t h)                                     \
+        {                                                                      \
+                if (!q || (h >= (blocks))) {                                   \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                return name##_ring_enqueue(&q->freed, &h);                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_pending(const name##_t *q)   \
+        {                                                                      \
+                return q ? name##_ring_count(&q->sent) : 0U;                   \
+        }
+
+#endif /* QUEUE_POOL_H */
@@ -0,0 +1,226 @@
+/*
+ * queue_prio.h
+ *
+ * Strict-priority SPSC queue built on QUEUE_DEFINE:
+ * QUEUE_DEFINE_PRIO(name, type, levels, capacity).
+ *
+ * - One QUEUE_DEFINE ring (`name##_band_t`) of `capacity` items per level;
+ *   level 0 is the highest priority, 1 <= `levels` <= 32.
+ * - A 32-bit ready mask has bit (31 - level) set while that band may hold
+ *   items, so the consumer finds the highest ready band with one load and a
+ *   count-leading-zeros instead of probing every band.
+ * - The producer only writes the mask when the band's bit is clear, so a
+ *   steady stream into a ready band touches no extra shared line. The
+ *   consumer clears a bit lazily when it finds the band empty and then
+ *   re-checks the band, which closes the race with a concurrent enqueue.
+ * - Bands follow QUEUE_OVERWRITE_ON_FULL; `name##_set_lossless(q, level,
+ *   true)` makes one band fail-on-full instead, so e.g. control traffic is
+ *   never dropped behind bulk data. With QUEUE_ENABLE_STATS every band keeps
+ *   its own counters (`name##_stats(q, level, &out)`).
+ */
+
+#ifndef QUEUE_PRIO_H
+#define QUEUE_PRIO_H
+
+#include "queue.h"
+#include <stdint.h>
+
+#if QUEUE_USE_C11_ATOMICS
+typedef _Atomic uint32_t queue__mask_t;
+#else
+typedef volatile uint32_t queue__mask_t;
+#endif
+
+#define QUEUE__PRIO_BIT(level) (UINT32_C(0x80000000) >> (level))
+
+static inline uint32_t
+queue__mask_load(const queue__mask_t *m)
+{
+#if QUEUE_USE_C11_ATOMICS
+        return atomic_load_explicit((queue__mask_t *)m, memory_order_acquire);
+#else
+        uint32_t v = *m;
+        QUEUE_BARRIER();
+        return v;
+#endif
+}
+
+/* Mark `bit` ready; called after the item is published in its band. */
+static inline void
+queue__mask_set(queue__mask_t *m, uint32_t bit)
+{
+#if QUEUE_USE_C11_ATOMICS
+        atomic_thread_fence(memory_order_seq_cst);
+        if ((atomic_load_explicit(m, memory_order_relaxed) & bit) == 0U) {
+                (void)atomic_fetch_or_explicit(m, bit, memory_order_release);
+        }
+#else
+        QUEUE_ENTER_CRITICAL();
+        *m |= bit;
+        QUEUE_EXIT_CRITICAL();
+#endif
+}
+
+/* Clear `bit`; the caller must re-check the band afterwards. */
+static inline void
+queue__mask_clear(queue__mask_t *m, uint32_t bit)
+{
+#if QUEUE_USE_C11_ATOMICS
+        (void)atomic_fetch_and_explicit(m, ~bit, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+#else
+        QUEUE_ENTER_CRITICAL();
+        *m &= ~bit;
+        QUEUE_EXIT_CRITICAL();
+#endif
+}
+
+/* Index of the most significant set bit, counted from bit 31; x != 0. */
+static inline unsigned
+queue__clz32(uint32_t x)
+{
+#if defined(__GNUC__)
+        return (unsigned)__builtin_clz(x);
+#else
+        unsigned n = 0U;
+        while ((x & UINT32_C(0x80000000)) == 0U) {
+                x <<= 1;
+                n++;
+        }
+        return n;
+#endif
+}
+
+#if QUEUE_ENABLE_STATS
+#define QUEUE__PRIO_STATS_DEFINE(name, levels)                                 \
+        static inline QUEUE__UNUSED queue_status_t name##_stats(               \
+            const name##_t *q, unsigned level, queue_stats_t *out)             \
+        {                                                                      \
+                if (!q || !out || (level >= (levels))) {                       \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                name##_band_stats(&q->band[level], out);                       \
+                return QUEUE_STATUS_OK;                                        \
+        }
+#else
+#define QUEUE__PRIO_STATS_DEFINE(name, levels)
+#endif
+
+/*
+ * QUEUE_DEFINE_PRIO(name, type, levels, capacity)
+ *
+ * - name##_enqueue(q, level, item)
+ * - name##_dequeue(q, out, &level): highest ready band first; `level` may
+ *   be NULL.
+ * - name##_set_lossless(q, level, on): configure before concurrent use.
+ */
+#define QUEUE_DEFINE_PRIO(name, type, levels, capacity)                        \
+        QUEUE__STATIC_ASSERT(name, ((levels) > 0U) && ((levels) <= 32U),       \
+                             "priority queue supports 1 to 32 levels");        \
+        QUEUE_DEFINE(name##_band, type, capacity)                              \
+                                                                               \
+        typedef struct {                                                       \
+                name##_band_t band[levels];                                    \
+                queue__mask_t ready;                                           \
+                uint32_t lossless;                                             \
+        } name##_t;                                                            \
+        QUEUE__PRIO_STATS_DEFINE(name, levels)                                 \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                for (unsigned i = 0U; i < (levels); i++) {                     \
+                        name##_band_init(&q->band[i]);                         \
+                }                                                              \
+                q->ready = 0U;                                                 \
+                q->lossless = 0U;                                              \
+        }                                                                      \
+        static inline QUEUE__UNUSED unsigned name##_levels(void)               \
+        {                                                                      \
+                return (levels);                                               \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_set_lossless(        \
+            name##_t *q, unsigned level, bool on)                              \
+        {                                                                      \
+                if (!q || (level >= (levels))) {                               \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                if (on) {                                                      \
+                        q->lossless |= QUEUE__PRIO_BIT(level);                 \
+                } else {                                                       \
+                        q->lossless &= ~QUEUE__PRIO_BIT(level);                \
+                }                                                              \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q,     \
+                                                        unsigned level)        \
+        {                                                                      \
+                if (!q || (level >= (levels))) {                              \
+                        return 0U;                                             \
+                }                                                              \
+                return name##_band_count(&q->band[level]);                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return true;                                           \
+                }                                                              \
+                uint32_t ready = queue__mask_load(&q->ready);                  \
+                while (ready != 0U) {                                          \
+                        const unsigned l = queue__clz32(ready);                \
+                        if (!name##_band_is_empty(&q->band[l])) {              \
+                                return false;                                  \
+                        }                                                      \
+                        ready &= ~QUEUE__PRIO_BIT(l);                          \
+                }                                                              \
+                return true;                                                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, unsigned level, const type *item)                     \
+        {                                                                      \
+                if (!q || !item || (level >= (levels))) {                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                name##_band_t *b = &q->band[level];                            \
+                const uint32_t bit = QUEUE__PRIO_BIT(level);                   \
+                if (QUEUE_OVERWRITE_ON_FULL && ((q->lossless & bit) != 0U) &&  \
+                    name##_band_is_full(b)) {                                  \
+                        QUEUE__STAT_PRODUCE(b, 0U, 0U, 1U, (capacity));        \
+                        return QUEUE_STATUS_FULL;                              \
+                }                                                              \
+                const queue_status_t st = name##_band_enqueue(b, item);        \
+                if (st != QUEUE_STATUS_FULL) {                                 \
+                        queue__mask_set(&q->ready, bit);                       \
+                }                                                              \
+                return st;                                                     \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(             \
+            name##_t *q, type *out, unsigned *level)                           \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                for (;;) {                                                     \
+                        const uint32_t ready = queue__mask_load(&q->ready);    \
+                        if (ready == 0U) {                                     \
+                                return QUEUE_STATUS_EMPTY;                     \
+                        }                                                      \
+                        const unsigned l = queue__clz32(ready);                \
+                        name##_band_t *b = &q->band[l];                        \
+                        if (name##_band_dequeue(b, out) == QUEUE_STATUS_OK) {  \
+                                if (level) {                                   \
+                                        *level = l;                            \
+                                }                                              \
+                                return QUEUE_STATUS_OK;                        \
+                        }                                                      \
+                        queue__mask_clear(&q->ready, QUEUE__PRIO_BIT(l));      \
+                        if (!name##_band_is_empty(b)) {                        \
+                                queue__mask_set(&q->ready,                     \
+                                                QUEUE__PRIO_BIT(l));           \
+                        }                                                      \
+                }                                                              \
+        }
+
+#endif /* QUEUE_PRIO_H */
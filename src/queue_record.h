@@ -0,0 +1,248 @@
+/*
+ * queue_record.h
+ *
+ * Single-producer/single-consumer variable-length record queue built on
+ * queue.h.
+ *
+ * - No dynamic allocation: the byte ring is embedded in the queue instance.
+ * - Each record is a `uint32_t` length header followed by the payload, padded
+ *   to QUEUE_RECORD_ALIGN. A record is never split across the end of the ring
+ *   (bip-buffer style): if it does not fit before the end, the producer leaves
+ *   a wrap marker and places it at offset 0, so every payload is contiguous.
+ * - Always fail-on-full; lock-free for SPSC with the same acquire/release
+ *   index protocol as QUEUE_DEFINE.
+ */
+
+#ifndef QUEUE_RECORD_H
+#define QUEUE_RECORD_H
+
+#include "queue.h"
+#include <stdint.h>
+
+#ifndef QUEUE_RECORD_ALIGN
+#define QUEUE_RECORD_ALIGN 4U
+#endif
+
+#if (QUEUE_RECORD_ALIGN < 4U) ||                                               \
+    ((QUEUE_RECORD_ALIGN & (QUEUE_RECORD_ALIGN - 1U)) != 0U)
+#error "QUEUE_RECORD_ALIGN must be a power of two >= 4"
+#endif
+
+#define QUEUE__RECORD_HDR  sizeof(uint32_t)
+#define QUEUE__RECORD_WRAP UINT32_MAX
+
+static inline size_t
+queue__record_span(size_t len)
+{
+        const size_t mask = (size_t)QUEUE_RECORD_ALIGN - 1U;
+        return (QUEUE__RECORD_HDR + len + mask) & ~mask;
+}
+
+static inline uint32_t
+queue__record_get_hdr(const uint8_t *p)
+{
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+}
+
+static inline void
+queue__record_set_hdr(uint8_t *p, uint32_t v)
+{
+        memcpy(p, &v, sizeof(v));
+}
+
+/*
+ * Find room for a `len` byte payload. Returns the record offset, or `size` if
+ * it does not fit. `head == tail` means empty, so the ring never fills up
+ * completely.
+ */
+static inline size_t
+queue__record_find(size_t size, size_t head, size_t tail, size_t len)
+{
+        if (len > UINT32_MAX - 1U || len > size) {
+                return size;
+        }
+        const size_t need = queue__record_span(len);
+        if (head >= tail) {
+                const size_t end_room = size - head;
+                if ((need < end_room) || ((need == end_room) && (tail != 0U))) {
+                        return head;
+                }
+                if (need < tail) {
+                        return 0U;
+                }
+                return size;
+        }
+        return (need < tail - head) ? head : size;
+}
+
+/* Offset of the oldest record, or `size` if empty. */
+static inline size_t
+queue__record_front(const uint8_t *buf, size_t size, size_t head, size_t tail)
+{
+        if (head == tail) {
+                return size;
+        }
+        if (queue__record_get_hdr(&buf[tail]) == QUEUE__RECORD_WRAP) {
+                return 0U;
+        }
+        return tail;
+}
+
+/*
+ * QUEUE_DEFINE_RECORD(name, size)
+ *
+ * Defines:
+ * - type: `name##_t` with a `size` byte ring (multiple of QUEUE_RECORD_ALIGN)
+ * - producer: `name##_reserve(q, len)` returns a pointer to `len` contiguous
+ *   payload bytes (NULL if there is no room), `name##_commit(q, len)`
+ *   publishes the record with its final length (<= reserved length).
+ *   `name##_enqueue(q, data, len)` copies a record in.
+ * - consumer: `name##_peek(q, &len)` returns the oldest payload (NULL if
+ *   empty), `name##_release(q)` frees it. `name##_dequeue(q, out, max, &len)`
+ *   copies it out (QUEUE_STATUS_BAD_ARG with `len` set if it exceeds `max`).
+ */
+#define QUEUE_DEFINE_RECORD(name, size)                                        \
+        QUEUE__STATIC_ASSERT(name,                                             \
+                             (((size) % QUEUE_RECORD_ALIGN) == 0U) &&          \
+                                 ((size) > QUEUE__RECORD_HDR),                 \
+                             "QUEUE_DEFINE_RECORD size must be a multiple of " \
+                             "QUEUE_RECORD_ALIGN");                            \
+        typedef struct {                                                       \
+                QUEUE__ALIGNED(QUEUE_RECORD_ALIGN) uint8_t buffer[size];       \
+                queue__index_t head;                                           \
+                queue__index_t tail;                                           \
+                size_t reserved_pos; /* producer-local */                      \
+                size_t reserved_len; /* producer-local */                      \
+        } name##_t;                                                            \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+                q->reserved_pos = (size);                                      \
+                q->reserved_len = 0U;                                          \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                name##_clear(q);                                               \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (size);                                                 \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return !q || (queue__load_acquire(&q->head) ==                 \
+                              queue__load_acquire(&q->tail));                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED void *name##_reserve(name##_t *q,          \
+                                                         size_t len)           \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return NULL;                                           \
+                }                                                              \
+                const size_t pos = queue__record_find(                         \
+                    (size), queue__load_relaxed(&q->head),                     \
+                    queue__load_acquire(&q->tail), len);                       \
+                q->reserved_pos = pos;                                         \
+                q->reserved_len = len;                                         \
+                if (pos == (size)) {                                           \
+                        return NULL;                                           \
+                }                                                              \
+                return &q->buffer[pos + QUEUE__RECORD_HDR];                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_commit(name##_t *q,  \
+                                                                 size_t len)   \
+        {                                                                      \
+                if (!q || (q->reserved_pos == (size)) ||                       \
+                    (len > q->reserved_len)) {                                 \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t pos = q->reserved_pos;                            \
+                if (pos != head) {                                             \
+                        queue__record_set_hdr(&q->buffer[head],                \
+                                              QUEUE__RECORD_WRAP);             \
+                }                                                              \
+                queue__record_set_hdr(&q->buffer[pos], (uint32_t)len);         \
+                size_t next = pos + queue__record_span(len);                   \
+                if (next == (size)) {                                          \
+                        next = 0U;                                             \
+                }                                                              \
+                q->reserved_pos = (size);                                      \
+                queue__store_release(&q->head, next);                          \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const void *data, size_t len)                         \
+        {                                                                      \
+                if (!q || (!data && (len != 0U))) {                            \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                void *dst = name##_reserve(q, len);                            \
+                if (!dst) {                                                    \
+                        return QUEUE_STATUS_FULL;                              \
+                }                                                              \
+                if (len != 0U) {                                               \
+                        memcpy(dst, data, len);                                \
+                }                                                              \
+                return name##_commit(q, len);                                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED const void *name##_peek(name##_t *q,       \
+                                                            size_t *len)       \
+        {                                                                      \
+                if (!q || !len) {                                              \
+                        return NULL;                                           \
+                }                                                              \
+                const size_t pos = queue__record_front(                        \
+                    q->buffer, (size), queue__load_acquire(&q->head),          \
+                    queue__load_relaxed(&q->tail));                            \
+                if (pos == (size)) {                                           \
+                        *len = 0U;                                             \
+                        return NULL;                                           \
+                }                                                              \
+                *len = queue__record_get_hdr(&q->buffer[pos]);                 \
+                return &q->buffer[pos + QUEUE__RECORD_HDR];                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_release(name##_t *q) \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t pos = queue__record_front(                        \
+                    q->buffer, (size), queue__load_acquire(&q->head),          \
+                    queue__load_relaxed(&q->tail));                            \
+                if (pos == (size)) {                                           \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                const uint32_t len = queue__record_get_hdr(&q->buffer[pos]);   \
+                size_t next = pos + queue__record_span(len);                   \
+                if (next == (size)) {                                          \
+                        next = 0U;                                             \
+                }                                                              \
+                queue__store_release(&q->tail, next);                          \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(             \
+            name##_t *q, void *out, size_t max, size_t *len)                   \
+        {                                                                      \
+                if (!q || !out || !len) {                                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const void *src = name##_peek(q, len);                         \
+                if (!src) {                                                    \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                if (*len > max) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                memcpy(out, src, *len);                                        \
+                return name##_release(q);                                      \
+        }
+
+#endif /* QUEUE_RECORD_H */
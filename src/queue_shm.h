@@ -0,0 +1,236 @@
+/*
+ * queue_shm.h
+ *
+ * Cross-process SPSC queues in POSIX shared memory built on queue.h:
+ * QUEUE_DEFINE_SHM(name, type, capacity).
+ *
+ * - The mapping starts with a versioned queue_shm_header_t (magic, version,
+ *   element size/alignment, capacity, index size, layout flags) followed by
+ *   a QUEUE_DEFINE_PADDED queue at `queue_offset`.
+ * - The queue holds no pointers, so every process may map it at a different
+ *   address. The one exception is the queue-set pointer added by
+ *   QUEUE_ENABLE_SET, which is left NULL by create and must stay so.
+ * - After create/attach, producer and consumer use the normal lock-free index
+ *   protocol directly on the mapping: no syscalls and no copies beyond the
+ *   ring itself.
+ * - Requires QUEUE_USE_C11_ATOMICS=1 with lock-free `size_t` atomics and
+ *   QUEUE_OVERWRITE_ON_FULL=0 (the overwrite path needs critical sections,
+ *   which are process-local).
+ * - `name##_dequeue_wait`/`name##_enqueue_wait`, the notify API and
+ *   `name##_set_attach` are process-local and must not be used on a shared
+ *   queue.
+ *
+ * Define _DEFAULT_SOURCE (or _POSIX_C_SOURCE >= 200809L) before including.
+ */
+
+#ifndef QUEUE_SHM_H
+#define QUEUE_SHM_H
+
+#include "queue.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if !QUEUE_USE_C11_ATOMICS
+#error "queue_shm.h requires QUEUE_USE_C11_ATOMICS=1"
+#endif
+#if QUEUE_OVERWRITE_ON_FULL
+#error "queue_shm.h requires QUEUE_OVERWRITE_ON_FULL=0"
+#endif
+
+#define QUEUE_SHM_MAGIC   0x51534d31U /* "QSM1" */
+#define QUEUE_SHM_VERSION 1U
+
+/* Layout flags: build options that change the shared struct. */
+#define QUEUE_SHM_FLAG_PADDED 0x1U
+#define QUEUE_SHM_FLAG_STATS  0x2U
+#define QUEUE_SHM_FLAG_WAIT   0x4U
+#define QUEUE_SHM_FLAG_NOTIFY 0x8U
+#define QUEUE_SHM_FLAG_SET    0x10U
+#define QUEUE_SHM_FLAG_TRACE  0x20U
+
+#define QUEUE__SHM_FLAGS                                                       \
+        (QUEUE_SHM_FLAG_PADDED |                                               \
+         (QUEUE_ENABLE_STATS ? QUEUE_SHM_FLAG_STATS : 0U) |                    \
+         (QUEUE_ENABLE_WAIT ? QUEUE_SHM_FLAG_WAIT : 0U) |                      \
+         (QUEUE_ENABLE_NOTIFY ? QUEUE_SHM_FLAG_NOTIFY : 0U) |                  \
+         (QUEUE_ENABLE_SET ? QUEUE_SHM_FLAG_SET : 0U) |                        \
+         (QUEUE_ENABLE_TRACE ? QUEUE_SHM_FLAG_TRACE : 0U))
+
+typedef struct {
+        _Atomic uint32_t magic; /* QUEUE_SHM_MAGIC once initialised */
+        uint32_t version;
+        uint32_t flags;
+        uint32_t elem_size;
+        uint32_t elem_align;
+        uint32_t index_size;
+        uint64_t queue_capacity;
+        uint64_t queue_offset;
+        uint64_t queue_size;
+} queue_shm_header_t;
+
+/* Header size rounded up to the queue's alignment. */
+#define QUEUE__SHM_OFFSET(align)                                               \
+        (((sizeof(queue_shm_header_t) + (align) - 1U) / (align)) * (align))
+
+/*
+ * Open (or exclusively create) the object at `path` and map `size` bytes.
+ * Attaching to an object that is still being created returns
+ * QUEUE_STATUS_EMPTY.
+ */
+static inline queue_status_t
+queue__shm_map(const char *path, bool create, size_t size, void **base)
+{
+        queue__index_t probe;
+        if (!atomic_is_lock_free(&probe)) {
+                return QUEUE_STATUS_BAD_ARG;
+        }
+        const int fd = shm_open(
+            path, create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR, 0600);
+        if (fd < 0) {
+                return QUEUE_STATUS_SYS_ERROR;
+        }
+        queue_status_t st = QUEUE_STATUS_OK;
+        struct stat sb;
+        if (create) {
+                if (ftruncate(fd, (off_t)size) != 0) {
+                        st = QUEUE_STATUS_SYS_ERROR;
+                }
+        } else if (fstat(fd, &sb) != 0) {
+                st = QUEUE_STATUS_SYS_ERROR;
+        } else if (sb.st_size == 0) {
+                st = QUEUE_STATUS_EMPTY;
+        } else if ((size_t)sb.st_size != size) {
+                st = QUEUE_STATUS_MISMATCH;
+        }
+        if (st == QUEUE_STATUS_OK) {
+                void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                               fd, 0);
+                if (p == MAP_FAILED) {
+                        st = QUEUE_STATUS_SYS_ERROR;
+                } else {
+                        *base = p;
+                }
+        }
+        const int err = errno;
+        (void)close(fd);
+        if (create && (st != QUEUE_STATUS_OK)) {
+                (void)shm_unlink(path);
+        }
+        errno = err;
+        return st;
+}
+
+static inline queue_status_t
+queue__shm_check(const queue_shm_header_t *h, const queue_shm_header_t *want)
+{
+        const uint32_t magic = atomic_load_explicit(
+            (_Atomic uint32_t *)&h->magic, memory_order_acquire);
+        if (magic == 0U) {
+                return QUEUE_STATUS_EMPTY;
+        }
+        if ((magic != QUEUE_SHM_MAGIC) || (h->version != want->version) ||
+            (h->flags != want->flags) || (h->elem_size != want->elem_size) ||
+            (h->elem_align != want->elem_align) ||
+            (h->index_size != want->index_size) ||
+            (h->queue_capacity != want->queue_capacity) ||
+            (h->queue_offset != want->queue_offset) ||
+            (h->queue_size != want->queue_size)) {
+                return QUEUE_STATUS_MISMATCH;
+        }
+        return QUEUE_STATUS_OK;
+}
+
+/*
+ * QUEUE_DEFINE_SHM(name, type, capacity)
+ *
+ * QUEUE_DEFINE_PADDED(name, type, capacity) plus:
+ * - `name##_shm_create(path, &q)`: create the shm object (O_EXCL), initialise
+ *   the queue and publish the header.
+ * - `name##_shm_attach(path, &q)`: map an existing object and validate its
+ *   header; QUEUE_STATUS_MISMATCH if it was built differently,
+ *   QUEUE_STATUS_EMPTY if the creator has not finished yet (retry).
+ * - `name##_shm_detach(q)`: unmap. Remove the object with shm_unlink().
+ * `type` must be trivially copyable and pointer-free to be meaningful in
+ * another process.
+ */
+#define QUEUE_DEFINE_SHM(name, type, capacity)                                 \
+        QUEUE_DEFINE_PADDED(name, type, capacity)                              \
+                                                                               \
+        static inline QUEUE__UNUSED size_t name##_shm_size(void)               \
+        {                                                                      \
+                return QUEUE__SHM_OFFSET(_Alignof(name##_t)) +                 \
+                       sizeof(name##_t);                                       \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##__shm_describe(                 \
+            queue_shm_header_t *h)                                             \
+        {                                                                      \
+                h->version = QUEUE_SHM_VERSION;                                \
+                h->flags = QUEUE__SHM_FLAGS;                                   \
+                h->elem_size = (uint32_t)sizeof(type);                         \
+                h->elem_align = (uint32_t)_Alignof(type);                      \
+                h->index_size = (uint32_t)sizeof(queue__index_t);              \
+                h->queue_capacity = (uint64_t)(capacity);                      \
+                h->queue_offset = QUEUE__SHM_OFFSET(_Alignof(name##_t));       \
+                h->queue_size = (uint64_t)sizeof(name##_t);                    \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_shm_create(          \
+            const char *path, name##_t **out)                                  \
+        {                                                                      \
+                if (!path || !out) {                                           \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                void *base = NULL;                                             \
+                const queue_status_t st =                                      \
+                    queue__shm_map(path, true, name##_shm_size(), &base);      \
+                if (st != QUEUE_STATUS_OK) {                                   \
+                        return st;                                             \
+                }                                                              \
+                queue_shm_header_t *h = (queue_shm_header_t *)base;            \
+                name##__shm_describe(h);                                       \
+                name##_t *q = (name##_t *)(void *)((char *)base +              \
+                                                   h->queue_offset);           \
+                name##_init(q);                                                \
+                atomic_store_explicit(&h->magic, QUEUE_SHM_MAGIC,              \
+                                      memory_order_release);                   \
+                *out = q;                                                      \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_shm_attach(          \
+            const char *path, name##_t **out)                                  \
+        {                                                                      \
+                if (!path || !out) {                                           \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                void *base = NULL;                                             \
+                queue_status_t st =                                            \
+                    queue__shm_map(path, false, name##_shm_size(), &base);     \
+                if (st != QUEUE_STATUS_OK) {                                   \
+                        return st;                                             \
+                }                                                              \
+                queue_shm_header_t want;                                       \
+                name##__shm_describe(&want);                                   \
+                st = queue__shm_check((const queue_shm_header_t *)base,        \
+                                      &want);                                  \
+                if (st != QUEUE_STATUS_OK) {                                   \
+                        (void)munmap(base, name##_shm_size());                 \
+                        return st;                                             \
+                }                                                              \
+                *out = (name##_t *)(void *)((char *)base +                     \
+                                            want.queue_offset);                \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_shm_detach(name##_t *q)        \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                char *base =                                                   \
+                    (char *)q - QUEUE__SHM_OFFSET(_Alignof(name##_t));         \
+                (void)munmap(base, name##_shm_size());                         \
+        }
+
+#endif /* QUEUE_SHM_H */
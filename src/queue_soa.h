@@ -0,0 +1,190 @@
+/*
+ * queue_soa.h
+ *
+ * Structure-of-arrays SPSC queue built on queue.h:
+ * QUEUE_DEFINE_SOA(name, capacity, FIELDS).
+ *
+ * - `FIELDS` is an X-macro taking (X, ctx) that expands X(ctx, type, field)
+ *   once per field:
+ *
+ *       #define SAMPLE_FIELDS(X, ctx) X(ctx, float, value)                    \
+ *                                     X(ctx, uint32_t, timestamp)
+ *       QUEUE_DEFINE_SOA(sample_q, 256, SAMPLE_FIELDS)
+ *
+ * - Every field lives in its own ring array (aligned to
+ *   QUEUE_CACHE_LINE_SIZE); all arrays share one head/tail, so slot `i` of
+ *   each array belongs to the same element.
+ * - `name##_item_t` is the matching plain struct for per-element
+ *   enqueue/dequeue. Batch consumers use `name##_peek_span`, which returns
+ *   a `name##_span_t` with one contiguous pointer per field, run vectorized
+ *   kernels over it and free the elements with `name##_release_n`.
+ *   Producers can fill fields in place with `name##_reserve_span` /
+ *   `name##_commit_n`.
+ * - Always fail-on-full; lock-free for SPSC with the same acquire/release
+ *   index protocol as QUEUE_DEFINE.
+ */
+
+#ifndef QUEUE_SOA_H
+#define QUEUE_SOA_H
+
+#include "queue.h"
+
+#define QUEUE__SOA_MEMBER(ctx, type, field) type field;
+#define QUEUE__SOA_ARRAY(ctx, type, field)                                     \
+        QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) type field[ctx];
+#define QUEUE__SOA_POINTER(ctx, type, field) type *field;
+#define QUEUE__SOA_STORE(ctx, type, field) q->field[ctx] = item->field;
+#define QUEUE__SOA_LOAD(ctx, type, field) out->field = q->field[ctx];
+#define QUEUE__SOA_SPAN(ctx, type, field) span->field = &q->field[ctx];
+
+/*
+ * QUEUE_DEFINE_SOA(name, capacity, FIELDS)
+ *
+ * - name##_enqueue(q, &item) / name##_dequeue(q, &item): one element.
+ * - name##_peek_span(q, &span): returns the number of queued elements that
+ *   are contiguous in every field array (up to the wrap point) and points
+ *   `span` at them; 0 if empty. name##_release_n(q, n) frees the first `n`
+ *   (QUEUE_STATUS_BAD_ARG if fewer are queued).
+ * - name##_reserve_span(q, &span) / name##_commit_n(q, n): the producer
+ *   counterpart for free slots; commit_n rejects `n` beyond the free space.
+ */
+#define QUEUE_DEFINE_SOA(name, capacity, fields)                               \
+        typedef struct {                                                       \
+                fields(QUEUE__SOA_MEMBER, 0)                                   \
+        } name##_item_t;                                                       \
+        typedef struct {                                                       \
+                fields(QUEUE__SOA_POINTER, 0)                                  \
+        } name##_span_t;                                                       \
+        typedef struct {                                                       \
+                fields(QUEUE__SOA_ARRAY, (capacity) + 1U)                      \
+                QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t head;     \
+                QUEUE__ALIGNED(QUEUE_CACHE_LINE_SIZE) queue__index_t tail;     \
+        } name##_t;                                                            \
+                                                                               \
+        static inline QUEUE__UNUSED void name##_clear(name##_t *q)             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return;                                                \
+                }                                                              \
+                queue__store_relaxed(&q->head, 0U);                            \
+                queue__store_relaxed(&q->tail, 0U);                            \
+        }                                                                      \
+        static inline QUEUE__UNUSED void name##_init(name##_t *q)              \
+        {                                                                      \
+                name##_clear(q);                                               \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_capacity(void)               \
+        {                                                                      \
+                return (capacity);                                             \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_count(const name##_t *q)     \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return 0U;                                             \
+                }                                                              \
+                const size_t head = queue__load_acquire(&q->head);             \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                return queue__ring_count(head, tail, (capacity) + 1U);         \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_empty(const name##_t *q)    \
+        {                                                                      \
+                return name##_count(q) == 0U;                                  \
+        }                                                                      \
+        static inline QUEUE__UNUSED bool name##_is_full(const name##_t *q)     \
+        {                                                                      \
+                return q && (name##_count(q) == (capacity));                   \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_enqueue(             \
+            name##_t *q, const name##_item_t *item)                            \
+        {                                                                      \
+                if (!q || !item) {                                             \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t next_head =                                       \
+                    queue__next_index(head, (capacity) + 1U);                  \
+                if (next_head == queue__load_acquire(&q->tail)) {              \
+                        return QUEUE_STATUS_FULL;                              \
+                }                                                              \
+                fields(QUEUE__SOA_STORE, head)                                 \
+                queue__store_release(&q->head, next_head);                     \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_dequeue(             \
+            name##_t *q, name##_item_t *out)                                   \
+        {                                                                      \
+                if (!q || !out) {                                              \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                if (queue__load_acquire(&q->head) == tail) {                   \
+                        return QUEUE_STATUS_EMPTY;                             \
+                }                                                              \
+                fields(QUEUE__SOA_LOAD, tail)                                  \
+                queue__store_release(                                          \
+                    &q->tail, queue__next_index(tail, (capacity) + 1U));       \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_peek_span(                   \
+            name##_t *q, name##_span_t *span)                                  \
+        {                                                                      \
+                if (!q || !span) {                                             \
+                        return 0U;                                             \
+                }                                                              \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                const size_t head = queue__load_acquire(&q->head);             \
+                const size_t n = (head >= tail) ? (head - tail)                \
+                                                : ((capacity) + 1U - tail);    \
+                fields(QUEUE__SOA_SPAN, tail)                                  \
+                return n;                                                      \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_release_n(           \
+            name##_t *q, size_t n)                                             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t tail = queue__load_relaxed(&q->tail);             \
+                const size_t head = queue__load_acquire(&q->head);             \
+                if (n > queue__ring_count(head, tail, (capacity) + 1U)) {      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                queue__store_release(                                          \
+                    &q->tail, queue__ring_add(tail, n, (capacity) + 1U));      \
+                return QUEUE_STATUS_OK;                                        \
+        }                                                                      \
+        static inline QUEUE__UNUSED size_t name##_reserve_span(                \
+            name##_t *q, name##_span_t *span)                                  \
+        {                                                                      \
+                if (!q || !span) {                                             \
+                        return 0U;                                             \
+                }                                                              \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                size_t n;                                                      \
+                if (tail > head) {                                             \
+                        n = tail - head - 1U;                                  \
+                } else {                                                       \
+                        n = (capacity) + 1U - head - ((tail == 0U) ? 1U : 0U); \
+                }                                                              \
+                fields(QUEUE__SOA_SPAN, head)                                  \
+                return n;                                                      \
+        }                                                                      \
+        static inline QUEUE__UNUSED queue_status_t name##_commit_n(            \
+            name##_t *q, size_t n)                                             \
+        {                                                                      \
+                if (!q) {                                                      \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                const size_t head = queue__load_relaxed(&q->head);             \
+                const size_t tail = queue__load_acquire(&q->tail);             \
+                if (n > (capacity) -                                           \
+                            queue__ring_count(head, tail, (capacity) + 1U)) {  \
+                        return QUEUE_STATUS_BAD_ARG;                           \
+                }                                                              \
+                queue__store_release(                                          \
+                    &q->head, queue__ring_add(head, n, (capacity) + 1U));      \
+                return QUEUE_STATUS_OK;                                        \
+        }
+
+#endif /* QUEUE_SOA_H */
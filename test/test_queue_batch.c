@@ -0,0 +1,121 @@
+#define _POSIX_C_SOURCE 200809L
+#define QUEUE_OVERWRITE_ON_FULL 0
+#include "queue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+#define MT_COUNT 2000000U
+#define BATCH    32U
+
+QUEUE_DEFINE(batch_q, int, 8)
+QUEUE_DEFINE_PADDED(batch_pad_q, unsigned, 1024)
+QUEUE_DEFINE_RUNTIME(batch_rt_q, int)
+
+static batch_pad_q_t pq;
+
+static void *
+consumer(void *arg)
+{
+        (void)arg;
+        for (unsigned expected = 0U; expected < MT_COUNT;) {
+                unsigned v;
+                if (batch_pad_q_dequeue(&pq, &v) == QUEUE_STATUS_OK) {
+                        assert(v == expected);
+                        expected++;
+                } else {
+                        sched_yield();
+                }
+        }
+        return NULL;
+}
+
+static double
+now_s(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+int
+main(void)
+{
+        batch_q_t q;
+        batch_q_producer_t p;
+        batch_q_init(&q);
+        assert(batch_q_producer_init(NULL, &q, 4U) == QUEUE_STATUS_BAD_ARG);
+        assert(batch_q_producer_init(&p, &q, 3U) == QUEUE_STATUS_OK);
+
+        /* Nothing is visible until the batch fills or flush is called. */
+        int v = 0;
+        assert(batch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        v = 1;
+        assert(batch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        assert(batch_q_is_empty(&q));
+        v = 2;
+        assert(batch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        assert(batch_q_count(&q) == 3U);
+        v = 3;
+        assert(batch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        assert(batch_q_count(&q) == 3U);
+        assert(batch_q_flush(&p) == QUEUE_STATUS_OK);
+        assert(batch_q_count(&q) == 4U);
+        assert(batch_q_flush(&p) == QUEUE_STATUS_OK);
+
+        /* Filling the ring publishes; a full ring is reported. */
+        for (v = 4; v < 8; v++) {
+                assert(batch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        }
+        assert(batch_q_is_full(&q));
+        assert(batch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_FULL);
+        for (int i = 0; i < 8; i++) {
+                assert(batch_q_dequeue(&q, &v) == QUEUE_STATUS_OK && v == i);
+        }
+        assert(batch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        assert(batch_q_flush(&p) == QUEUE_STATUS_OK);
+        assert(batch_q_dequeue(&q, &v) == QUEUE_STATUS_OK && v == 7);
+
+        /* The plain producer calls resume after a flush. */
+        v = 42;
+        assert(batch_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+        assert(batch_q_dequeue(&q, &v) == QUEUE_STATUS_OK && v == 42);
+
+        /* Run-time sized queues get the same handle. */
+        static int storage[QUEUE_RUNTIME_SLOTS(4)];
+        batch_rt_q_t rq;
+        batch_rt_q_producer_t rp;
+        assert(batch_rt_q_init(&rq, storage, QUEUE_RUNTIME_SLOTS(4)) ==
+               QUEUE_STATUS_OK);
+        assert(batch_rt_q_producer_init(&rp, &rq, 8U) == QUEUE_STATUS_OK);
+        for (v = 0; v < 4; v++) {
+                assert(batch_rt_q_producer_enqueue(&rp, &v) ==
+                       QUEUE_STATUS_OK);
+        }
+        assert(batch_rt_q_producer_enqueue(&rp, &v) == QUEUE_STATUS_FULL);
+        assert(batch_rt_q_count(&rq) == 4U);
+
+        /* Cross-thread stream through a padded queue. */
+        batch_pad_q_init(&pq);
+        batch_pad_q_producer_t pp;
+        assert(batch_pad_q_producer_init(&pp, &pq, BATCH) == QUEUE_STATUS_OK);
+        pthread_t th;
+        const double t0 = now_s();
+        pthread_create(&th, NULL, consumer, NULL);
+        for (unsigned i = 0U; i < MT_COUNT; i++) {
+                while (batch_pad_q_producer_enqueue(&pp, &i) ==
+                       QUEUE_STATUS_FULL) {
+                        sched_yield();
+                }
+        }
+        assert(batch_pad_q_flush(&pp) == QUEUE_STATUS_OK);
+        pthread_join(th, NULL);
+        assert(batch_pad_q_is_empty(&pq));
+        printf("batch %u: %.1f Mops/s\n", BATCH,
+               (double)MT_COUNT / (now_s() - t0) / 1e6);
+
+        printf("All batch tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200809L
+#include "queue_bcast.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define READERS  3U
+#define MT_COUNT 300000U
+
+QUEUE_DEFINE_BCAST(fan_q, unsigned, 4, READERS)
+QUEUE_DEFINE_BCAST(mt_fan_q, unsigned, 256, READERS)
+
+static mt_fan_q_t mq;
+static size_t mt_lost[READERS];
+
+static void *
+reader(void *arg)
+{
+        const size_t id = (size_t)arg;
+        unsigned expected = 0U;
+        while (expected < MT_COUNT) {
+                unsigned v;
+                size_t lost;
+                if (mt_fan_q_dequeue(&mq, id, &v, &lost) != QUEUE_STATUS_OK) {
+                        sched_yield();
+                        continue;
+                }
+                /* In order; gaps only where the producer lapped us. */
+                assert(v == expected + lost);
+                mt_lost[id] += lost;
+                expected = v + 1U;
+                if ((id == READERS - 1U) && ((v % 64U) == 0U)) {
+                        sched_yield();
+                }
+        }
+        return NULL;
+}
+
+int
+main(void)
+{
+        fan_q_t q;
+        unsigned v = 0U;
+        size_t lost = 99U;
+        fan_q_init(&q);
+        assert(fan_q_capacity() == 4U && fan_q_consumers() == READERS);
+        assert(fan_q_attach(&q, READERS) == QUEUE_STATUS_BAD_ARG);
+        assert(fan_q_dequeue(&q, READERS, &v, NULL) == QUEUE_STATUS_BAD_ARG);
+        for (size_t id = 0U; id < READERS; id++) {
+                assert(fan_q_attach(&q, id) == QUEUE_STATUS_OK);
+        }
+
+        /* Every consumer sees every item once, in order. */
+        for (v = 0U; v < 3U; v++) {
+                assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+        }
+        for (size_t id = 0U; id < READERS; id++) {
+                assert(fan_q_count(&q, id) == 3U);
+                for (unsigned i = 0U; i < 3U; i++) {
+                        assert(fan_q_dequeue(&q, id, &v, &lost) ==
+                               QUEUE_STATUS_OK);
+                        assert(v == i && lost == 0U);
+                }
+                assert(fan_q_dequeue(&q, id, &v, &lost) == QUEUE_STATUS_EMPTY);
+                assert(fan_q_is_empty(&q, id));
+        }
+
+        /* Consumers 0 and 1 keep up, consumer 2 falls behind. */
+        for (v = 10U; v < 14U; v++) {
+                assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+                assert(fan_q_dequeue(&q, 0U, &v, NULL) == QUEUE_STATUS_OK);
+                assert(fan_q_dequeue(&q, 1U, &v, NULL) == QUEUE_STATUS_OK);
+        }
+        assert(fan_q_count(&q, 2U) == 4U);
+        v = 14U;
+#if QUEUE_OVERWRITE_ON_FULL
+        assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_OVERWROTE);
+        v = 15U;
+        assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_OVERWROTE);
+        assert(fan_q_dequeue(&q, 2U, &v, &lost) == QUEUE_STATUS_OK);
+        assert(v == 12U && lost == 2U);
+        assert(fan_q_dequeue(&q, 2U, &v, &lost) == QUEUE_STATUS_OK);
+        assert(v == 13U && lost == 0U);
+#else
+        /* The slowest consumer gates the producer until it detaches. */
+        assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_FULL);
+        assert(fan_q_dequeue(&q, 2U, &v, &lost) == QUEUE_STATUS_OK);
+        assert(v == 10U && lost == 0U);
+        v = 14U;
+        assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+        assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_FULL);
+        assert(fan_q_detach(&q, 2U) == QUEUE_STATUS_OK);
+        assert(fan_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+#endif
+
+        /* One producer, three concurrent consumers. */
+        mt_fan_q_init(&mq);
+        pthread_t th[READERS];
+        for (size_t id = 0U; id < READERS; id++) {
+                assert(mt_fan_q_attach(&mq, id) == QUEUE_STATUS_OK);
+                pthread_create(&th[id], NULL, reader, (void *)id);
+        }
+        for (unsigned i = 0U; i < MT_COUNT; i++) {
+                while (mt_fan_q_enqueue(&mq, &i) == QUEUE_STATUS_FULL) {
+                        sched_yield();
+                }
+                if ((i % 128U) == 0U) {
+                        sched_yield();
+                }
+        }
+        for (size_t id = 0U; id < READERS; id++) {
+                pthread_join(th[id], NULL);
+        }
+#if !QUEUE_OVERWRITE_ON_FULL
+        for (size_t id = 0U; id < READERS; id++) {
+                assert(mt_lost[id] == 0U);
+        }
+#endif
+        printf("lost per consumer: %zu %zu %zu\n", mt_lost[0], mt_lost[1],
+               mt_lost[2]);
+
+        printf("All broadcast tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,85 @@
+#include "queue.h"
+#include <assert.h>
+#include <stdio.h>
+
+typedef int elem_t;
+QUEUE_DEFINE(bulk_q, elem_t, 5)
+QUEUE_DEFINE_PADDED(bulk_pad_q, elem_t, 5)
+
+int
+main(void)
+{
+        bulk_q_t q;
+        bulk_q_init(&q);
+
+        elem_t in[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+        elem_t out[8] = {0};
+        size_t n = 99U;
+
+        assert(bulk_q_enqueue_bulk(NULL, in, 1U, &n) == QUEUE_STATUS_BAD_ARG);
+        assert(bulk_q_enqueue_bulk(&q, in, 1U, NULL) == QUEUE_STATUS_BAD_ARG);
+        assert(bulk_q_dequeue_bulk(&q, NULL, 1U, &n) == QUEUE_STATUS_BAD_ARG);
+        assert(bulk_q_dequeue_bulk(&q, out, 8U, &n) == QUEUE_STATUS_EMPTY);
+        assert(n == 0U);
+
+        /* Move head/tail to 4 so the next bulk write splits at the wrap. */
+        assert(bulk_q_enqueue_bulk(&q, in, 4U, &n) == QUEUE_STATUS_OK);
+        assert(n == 4U);
+        assert(bulk_q_dequeue_bulk(&q, out, 8U, &n) == QUEUE_STATUS_OK);
+        assert(n == 4U);
+        for (size_t i = 0; i < 4U; i++) {
+                assert(out[i] == in[i]);
+        }
+
+        assert(bulk_q_enqueue_bulk(&q, in, 3U, &n) == QUEUE_STATUS_OK);
+        assert(n == 3U);
+        assert(bulk_q_count(&q) == 3U);
+
+        /* 3 queued, 2 free: a 4-item write overflows by 2. */
+#if QUEUE_OVERWRITE_ON_FULL
+        assert(bulk_q_enqueue_bulk(&q, &in[3], 4U, &n) ==
+               QUEUE_STATUS_OVERWROTE);
+        assert(n == 4U);
+        const elem_t expected[] = {2, 3, 4, 5, 6};
+#else
+        assert(bulk_q_enqueue_bulk(&q, &in[3], 4U, &n) == QUEUE_STATUS_FULL);
+        assert(n == 2U);
+        const elem_t expected[] = {0, 1, 2, 3, 4};
+#endif
+        assert(bulk_q_is_full(&q));
+
+        /* Partial drain, then the rest across the wrap point. */
+        assert(bulk_q_dequeue_bulk(&q, out, 2U, &n) == QUEUE_STATUS_OK);
+        assert(n == 2U);
+        assert(bulk_q_dequeue_bulk(&q, &out[2], 8U, &n) == QUEUE_STATUS_OK);
+        assert(n == 3U);
+        for (size_t i = 0; i < 5U; i++) {
+                assert(out[i] == expected[i]);
+        }
+        assert(bulk_q_is_empty(&q));
+
+        /* Mixing bulk and single-item calls keeps padded caches coherent. */
+        bulk_pad_q_t p;
+        bulk_pad_q_init(&p);
+        for (int round = 0; round < 7; round++) {
+                elem_t v = 100 + round;
+                assert(bulk_pad_q_enqueue(&p, &v) == QUEUE_STATUS_OK);
+                assert(bulk_pad_q_enqueue_bulk(&p, in, 4U, &n) ==
+                       QUEUE_STATUS_OK);
+                assert(bulk_pad_q_is_full(&p));
+#if !QUEUE_OVERWRITE_ON_FULL
+                assert(bulk_pad_q_enqueue(&p, &v) == QUEUE_STATUS_FULL);
+#endif
+                assert(bulk_pad_q_dequeue_bulk(&p, out, 3U, &n) ==
+                       QUEUE_STATUS_OK);
+                assert(out[0] == v && out[1] == 0 && out[2] == 1);
+                assert(bulk_pad_q_dequeue(&p, &v) == QUEUE_STATUS_OK);
+                assert(v == 2);
+                assert(bulk_pad_q_dequeue(&p, &v) == QUEUE_STATUS_OK);
+                assert(v == 3);
+                assert(bulk_pad_q_dequeue(&p, &v) == QUEUE_STATUS_EMPTY);
+        }
+
+        printf("Bulk enqueue/dequeue tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,119 @@
+#define _POSIX_C_SOURCE 200809L
+#include "queue_conflate.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define KEYS     16U
+#define MT_COUNT 1000000U
+
+typedef struct {
+        uint32_t seq;
+        uint32_t check;
+} sample_t;
+
+QUEUE_DEFINE_CONFLATE(quote_q, int, 4)
+QUEUE_DEFINE_CONFLATE(mt_quote_q, sample_t, KEYS)
+
+static mt_quote_q_t mq;
+static uint32_t final_seq[KEYS];
+static atomic_bool producer_done;
+
+static void *
+producer(void *arg)
+{
+        (void)arg;
+        unsigned x = 3U;
+        for (uint32_t i = 1U; i <= MT_COUNT; i++) {
+                x = (x * 1103515245U) + 12345U;
+                const unsigned key = (x >> 16) % KEYS;
+                const sample_t s = {i, ~i};
+                (void)mt_quote_q_update(&mq, key, &s);
+                final_seq[key] = i;
+                if ((i % 256U) == 0U) {
+                        sched_yield();
+                }
+        }
+        atomic_store(&producer_done, true);
+        return NULL;
+}
+
+int
+main(void)
+{
+        quote_q_t q;
+        int v = 0;
+        unsigned key = 99U;
+        quote_q_init(&q);
+        assert(quote_q_keys() == 4U && quote_q_is_empty(&q));
+        assert(quote_q_update(&q, 4U, &v) == QUEUE_STATUS_BAD_ARG);
+        assert(quote_q_dequeue(&q, &v, &key) == QUEUE_STATUS_EMPTY);
+
+        /* Pending keys are replaced in place; oldest key first. */
+        v = 10;
+        assert(quote_q_update(&q, 2U, &v) == QUEUE_STATUS_OK);
+        v = 20;
+        assert(quote_q_update(&q, 0U, &v) == QUEUE_STATUS_OK);
+        v = 11;
+        assert(quote_q_update(&q, 2U, &v) == QUEUE_STATUS_OVERWROTE);
+        v = 12;
+        assert(quote_q_update(&q, 2U, &v) == QUEUE_STATUS_OVERWROTE);
+        assert(quote_q_count(&q) == 2U);
+        assert(quote_q_dequeue(&q, &v, &key) == QUEUE_STATUS_OK);
+        assert(key == 2U && v == 12);
+        assert(quote_q_dequeue(&q, &v, &key) == QUEUE_STATUS_OK);
+        assert(key == 0U && v == 20);
+        assert(quote_q_dequeue(&q, &v, NULL) == QUEUE_STATUS_EMPTY);
+
+        /* Every key pending at once fits; a delivered key can requeue. */
+        for (unsigned k = 0U; k < 4U; k++) {
+                v = (int)k;
+                assert(quote_q_update(&q, k, &v) == QUEUE_STATUS_OK);
+                assert(quote_q_update(&q, k, &v) == QUEUE_STATUS_OVERWROTE);
+        }
+        assert(quote_q_count(&q) == 4U);
+        assert(quote_q_dequeue(&q, &v, &key) == QUEUE_STATUS_OK);
+        assert(key == 0U && v == 0);
+        v = 5;
+        assert(quote_q_update(&q, 0U, &v) == QUEUE_STATUS_OK);
+        for (unsigned k = 1U; k < 4U; k++) {
+                assert(quote_q_dequeue(&q, &v, &key) == QUEUE_STATUS_OK);
+                assert(key == k && v == (int)k);
+        }
+        assert(quote_q_dequeue(&q, &v, &key) == QUEUE_STATUS_OK);
+        assert(key == 0U && v == 5);
+        assert(quote_q_is_empty(&q));
+
+        /* Concurrent updates: per-key values only move forward. */
+        mt_quote_q_init(&mq);
+        pthread_t th;
+        pthread_create(&th, NULL, producer, NULL);
+        uint32_t last[KEYS] = {0U};
+        unsigned delivered = 0U;
+        for (;;) {
+                const bool finished = atomic_load(&producer_done);
+                sample_t s;
+                if (mt_quote_q_dequeue(&mq, &s, &key) == QUEUE_STATUS_OK) {
+                        assert(s.check == ~s.seq);
+                        assert(s.seq > last[key]);
+                        last[key] = s.seq;
+                        delivered++;
+                } else if (finished) {
+                        break;
+                } else {
+                        sched_yield();
+                }
+        }
+        pthread_join(th, NULL);
+        for (unsigned k = 0U; k < KEYS; k++) {
+                assert(last[k] == final_seq[k]);
+        }
+        assert(delivered <= MT_COUNT);
+        printf("%u updates, %u delivered\n", MT_COUNT, delivered);
+
+        printf("All conflating queue tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+#include "queue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define MT_COUNT 1000000U
+
+QUEUE_DEFINE(vis_q, int, 5)
+QUEUE_DEFINE_PADDED(vis_mt_q, unsigned, 256)
+QUEUE_DEFINE_RUNTIME(vis_rt_q, int)
+
+typedef struct {
+        int seen[16];
+        size_t n;
+} log_t;
+
+static void
+record(int *item, void *ctx)
+{
+        log_t *log = (log_t *)ctx;
+        log->seen[log->n++] = *item;
+        *item = -1; /* in place: the slot itself is visited */
+}
+
+#if !QUEUE_OVERWRITE_ON_FULL
+static vis_mt_q_t mq;
+
+static void
+check(unsigned *item, void *ctx)
+{
+        unsigned *expected = (unsigned *)ctx;
+        assert(*item == *expected);
+        (*expected)++;
+}
+
+static void *
+producer(void *arg)
+{
+        (void)arg;
+        for (unsigned i = 0U; i < MT_COUNT; i++) {
+                while (vis_mt_q_enqueue(&mq, &i) == QUEUE_STATUS_FULL) {
+                        sched_yield();
+                }
+        }
+        return NULL;
+}
+#endif
+
+int
+main(void)
+{
+        vis_q_t q;
+        log_t log = {{0}, 0U};
+        vis_q_init(&q);
+        assert(vis_q_consume(NULL, 4U, record, &log) == 0U);
+        assert(vis_q_consume(&q, 4U, NULL, &log) == 0U);
+        assert(vis_q_consume(&q, 4U, record, &log) == 0U);
+
+        /* Wrapped contents are visited oldest first across both runs. */
+        int v, out[4];
+        size_t n;
+        const int fill[4] = {0, 1, 2, 3};
+        assert(vis_q_enqueue_bulk(&q, fill, 4U, &n) == QUEUE_STATUS_OK);
+        assert(vis_q_dequeue_bulk(&q, out, 4U, &n) == QUEUE_STATUS_OK);
+        for (v = 10; v < 15; v++) {
+                assert(vis_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+        }
+        assert(vis_q_consume(&q, 3U, record, &log) == 3U);
+        assert(vis_q_count(&q) == 2U);
+        assert(vis_q_consume(&q, 16U, record, &log) == 2U);
+        assert(vis_q_is_empty(&q));
+        assert(log.n == 5U);
+        for (size_t i = 0U; i < 5U; i++) {
+                assert(log.seen[i] == 10 + (int)i);
+        }
+
+#if QUEUE_OVERWRITE_ON_FULL
+        /* After an overwrite only the surviving items are visited. */
+        log.n = 0U;
+        for (v = 20; v < 27; v++) {
+                (void)vis_q_enqueue(&q, &v);
+        }
+        assert(vis_q_consume(&q, 16U, record, &log) == 5U);
+        assert(log.seen[0] == 22 && log.seen[4] == 26);
+#endif
+
+        /* Run-time sized queues provide the same call. */
+        static int storage[QUEUE_RUNTIME_SLOTS(3)];
+        vis_rt_q_t rq;
+        assert(vis_rt_q_init(&rq, storage, QUEUE_RUNTIME_SLOTS(3)) ==
+               QUEUE_STATUS_OK);
+        log.n = 0U;
+        for (v = 0; v < 3; v++) {
+                assert(vis_rt_q_enqueue(&rq, &v) == QUEUE_STATUS_OK);
+        }
+        assert(vis_rt_q_consume(&rq, 8U, record, &log) == 3U);
+        assert(log.n == 3U && log.seen[2] == 2 && vis_rt_q_is_empty(&rq));
+
+#if !QUEUE_OVERWRITE_ON_FULL
+        /* Concurrent producer: drain in batches, order preserved. */
+        vis_mt_q_init(&mq);
+        pthread_t th;
+        pthread_create(&th, NULL, producer, NULL);
+        unsigned expected = 0U;
+        while (expected < MT_COUNT) {
+                if (vis_mt_q_consume(&mq, 64U, check, &expected) == 0U) {
+                        sched_yield();
+                }
+        }
+        pthread_join(th, NULL);
+        assert(vis_mt_q_is_empty(&mq));
+#endif
+
+        printf("All consume tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,127 @@
+#define _POSIX_C_SOURCE 200809L
+#include "queue_mp.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define MT_PRODUCERS 8
+#define MT_CONSUMERS 8
+#define MT_PER_PRODUCER 125000
+#define MT_TOTAL (MT_PRODUCERS * MT_PER_PRODUCER)
+QUEUE_DEFINE_MPMC(mpmc_queue, uint32_t, 1024)
+QUEUE_DEFINE_MPMC(small_mpmc_q, int, 4)
+QUEUE_DEFINE_MPMC(tiny_mpmc_q, int, 2)
+
+static mpmc_queue_t q;
+static atomic_uchar seen[MT_TOTAL];
+static atomic_uint consumed = 0;
+
+void *
+producer(void *arg)
+{
+        const uint32_t id = (uint32_t)(uintptr_t)arg;
+        for (uint32_t i = 0; i < MT_PER_PRODUCER; i++) {
+                const uint32_t item = id * MT_PER_PRODUCER + i;
+                while (mpmc_queue_enqueue(&q, &item) == QUEUE_STATUS_FULL) {
+                        sched_yield();
+                }
+        }
+        return NULL;
+}
+
+void *
+consumer(void *arg)
+{
+        (void)arg;
+        while (atomic_load(&consumed) < MT_TOTAL) {
+                uint32_t val;
+                if (mpmc_queue_dequeue(&q, &val) == QUEUE_STATUS_OK) {
+                        assert(val < MT_TOTAL);
+                        /* exactly once: no item may be seen twice */
+                        if (atomic_fetch_add(&seen[val], 1U) != 0U) {
+                                fprintf(stderr, "item %u delivered twice\n",
+                                        val);
+                                assert(0);
+                        }
+                        atomic_fetch_add(&consumed, 1U);
+                } else {
+                        sched_yield();
+                }
+        }
+        return NULL;
+}
+
+int
+main(void)
+{
+        small_mpmc_q_t s;
+        small_mpmc_q_init(&s);
+        int out = 0;
+        assert(small_mpmc_q_dequeue(&s, &out) == QUEUE_STATUS_EMPTY);
+        assert(small_mpmc_q_dequeue(&s, NULL) == QUEUE_STATUS_BAD_ARG);
+        for (int i = 0; i < 4; i++) {
+                assert(small_mpmc_q_enqueue(&s, &i) == QUEUE_STATUS_OK);
+        }
+        assert(small_mpmc_q_enqueue(&s, &out) == QUEUE_STATUS_FULL);
+        assert(small_mpmc_q_count(&s) == 4U);
+        for (int i = 0; i < 4; i++) {
+                assert(small_mpmc_q_dequeue(&s, &out) == QUEUE_STATUS_OK);
+                assert(out == i);
+        }
+        assert(small_mpmc_q_is_empty(&s));
+
+        /* Smallest legal capacity: slots are reused across several laps. */
+        tiny_mpmc_q_t t;
+        tiny_mpmc_q_init(&t);
+        for (int lap = 0; lap < 3; lap++) {
+                int a = 2 * lap, b = (2 * lap) + 1;
+                assert(tiny_mpmc_q_enqueue(&t, &a) == QUEUE_STATUS_OK);
+                assert(tiny_mpmc_q_enqueue(&t, &b) == QUEUE_STATUS_OK);
+                assert(tiny_mpmc_q_enqueue(&t, &a) == QUEUE_STATUS_FULL);
+                assert(tiny_mpmc_q_dequeue(&t, &out) == QUEUE_STATUS_OK);
+                assert(out == a);
+                assert(tiny_mpmc_q_dequeue(&t, &out) == QUEUE_STATUS_OK);
+                assert(out == b);
+                assert(tiny_mpmc_q_dequeue(&t, &out) == QUEUE_STATUS_EMPTY);
+        }
+
+        mpmc_queue_init(&q);
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        pthread_t prod_threads[MT_PRODUCERS], cons_threads[MT_CONSUMERS];
+        for (uintptr_t c = 0; c < MT_CONSUMERS; c++) {
+                pthread_create(&cons_threads[c], NULL, consumer, NULL);
+        }
+        for (uintptr_t p = 0; p < MT_PRODUCERS; p++) {
+                pthread_create(&prod_threads[p], NULL, producer, (void *)p);
+        }
+        for (size_t p = 0; p < MT_PRODUCERS; p++) {
+                pthread_join(prod_threads[p], NULL);
+        }
+        for (size_t c = 0; c < MT_CONSUMERS; c++) {
+                pthread_join(cons_threads[c], NULL);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        /* every item delivered */
+        for (size_t i = 0; i < MT_TOTAL; i++) {
+                assert(atomic_load(&seen[i]) == 1U);
+        }
+        assert(mpmc_queue_is_empty(&q));
+
+        const double secs = (double)(t1.tv_sec - t0.tv_sec) +
+                            (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+        printf("MPMC: %d producers, %d consumers, %d items in %.3f s "
+               "(%.2f Mops/s)\n",
+               MT_PRODUCERS, MT_CONSUMERS, MT_TOTAL, secs,
+               (double)MT_TOTAL / secs / 1e6);
+        printf("Multi-threaded MPMC test passed.\n");
+        return 0;
+}
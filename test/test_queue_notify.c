@@ -0,0 +1,97 @@
+#define _GNU_SOURCE
+#define QUEUE_OVERWRITE_ON_FULL 0
+#define QUEUE_ENABLE_NOTIFY 1
+#include "queue.h"
+#include <assert.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+
+#define ITEMS 100000U
+
+typedef unsigned elem_t;
+QUEUE_DEFINE(notify_q, elem_t, 64)
+
+static notify_q_t q;
+
+static bool
+readable(int fd, int timeout_ms)
+{
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        return poll(&pfd, 1, timeout_ms) == 1;
+}
+
+static void *
+producer(void *arg)
+{
+        (void)arg;
+        for (elem_t i = 0U; i < ITEMS; i++) {
+                while (notify_q_enqueue(&q, &i) != QUEUE_STATUS_OK) {
+                }
+        }
+        return NULL;
+}
+
+int
+main(void)
+{
+        notify_q_init(&q);
+        assert(notify_q_notify_fd(&q) < 0);
+        const int fd = notify_q_notify_open(&q);
+        assert(fd >= 0 && notify_q_notify_fd(&q) == fd);
+        assert(!readable(fd, 0));
+
+        /* A burst of enqueues signals the eventfd exactly once. */
+        elem_t in[3] = {1U, 2U, 3U};
+        size_t n = 0U;
+        assert(notify_q_enqueue(&q, &in[0]) == QUEUE_STATUS_OK);
+        assert(notify_q_enqueue_bulk(&q, &in[1], 2U, &n) == QUEUE_STATUS_OK);
+        assert(notify_q_reserve(&q) != NULL);
+        assert(notify_q_commit(&q) == QUEUE_STATUS_OK);
+        assert(readable(fd, 0));
+        uint64_t events = 0U;
+        assert(read(fd, &events, sizeof(events)) == sizeof(events));
+        assert(events == 1U);
+        assert(!readable(fd, 0));
+
+        /* Items published before re-arming are reported by rearm. */
+        elem_t v;
+        while (notify_q_dequeue(&q, &v) == QUEUE_STATUS_OK) {
+        }
+        assert(notify_q_enqueue(&q, &in[0]) == QUEUE_STATUS_OK);
+        assert(!readable(fd, 0));
+        assert(notify_q_notify_rearm(&q));
+        assert(notify_q_dequeue(&q, &v) == QUEUE_STATUS_OK);
+        assert(!notify_q_notify_rearm(&q));
+        assert(notify_q_enqueue(&q, &in[0]) == QUEUE_STATUS_OK);
+        assert(readable(fd, 0));
+        assert(notify_q_dequeue(&q, &v) == QUEUE_STATUS_OK);
+        assert(!notify_q_notify_rearm(&q));
+        assert(!readable(fd, 0));
+
+        /* Event-loop consumer against a concurrent producer. */
+        pthread_t th;
+        assert(pthread_create(&th, NULL, producer, NULL) == 0);
+        elem_t expect = 0U;
+        unsigned wakeups = 0U;
+        while (expect < ITEMS) {
+                assert(readable(fd, 5000));
+                wakeups++;
+                do {
+                        while (notify_q_dequeue(&q, &v) == QUEUE_STATUS_OK) {
+                                assert(v == expect);
+                                expect++;
+                        }
+                } while (notify_q_notify_rearm(&q));
+        }
+        assert(pthread_join(th, NULL) == 0);
+        assert(wakeups <= ITEMS);
+
+        notify_q_notify_close(&q);
+        assert(notify_q_notify_fd(&q) < 0);
+        assert(notify_q_enqueue(&q, &in[0]) == QUEUE_STATUS_OK);
+
+        printf("All notify tests passed (%u wakeups for %u items).\n",
+               wakeups, ITEMS);
+        return 0;
+}
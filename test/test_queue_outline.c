@@ -0,0 +1,155 @@
+#include "queue.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STEPS 200000U
+
+typedef struct {
+        unsigned char b[3];
+} elem_t;
+
+QUEUE_DEFINE(ref_q, elem_t, 7)
+QUEUE_DEFINE_OUTLINE(out_q, elem_t, 7)
+
+static unsigned rng = 1U;
+
+static unsigned
+next_rand(void)
+{
+        rng = (rng * 1103515245U) + 12345U;
+        return rng >> 16;
+}
+
+typedef struct {
+        elem_t items[9];
+        size_t n;
+} sink_t;
+
+static void
+collect(elem_t *item, void *ctx)
+{
+        sink_t *sink = (sink_t *)ctx;
+        sink->items[sink->n++] = *item;
+}
+
+static bool
+same(const elem_t *a, const elem_t *b)
+{
+        return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+int
+main(void)
+{
+        ref_q_t ref;
+        out_q_t q;
+        ref_q_init(&ref);
+        out_q_init(&q);
+        assert(out_q_capacity() == 7U);
+        assert(out_q_enqueue(NULL, NULL) == QUEUE_STATUS_BAD_ARG);
+        assert(out_q_count(NULL) == 0U && out_q_is_empty(NULL));
+
+        queue_core_t core;
+        elem_t storage[4];
+        assert(queue_core_init(&core, storage, 0U, 4U, false) ==
+               QUEUE_STATUS_BAD_ARG);
+        assert(queue_core_init(&core, storage, sizeof(elem_t), 1U, false) ==
+               QUEUE_STATUS_BAD_ARG);
+
+        /* Random operation mix in lockstep with the inline implementation. */
+        unsigned char seq = 0U;
+        for (unsigned step = 0U; step < STEPS; step++) {
+                elem_t in[9], a[9], b[9];
+                size_t na = 0U, nb = 0U;
+                const size_t n = next_rand() % 10U;
+                for (size_t i = 0; i < n; i++) {
+                        memset(&in[i], seq++, sizeof(in[i]));
+                }
+                switch (next_rand() % 9U) {
+                case 0:
+                        assert(ref_q_enqueue(&ref, &in[0]) ==
+                               out_q_enqueue(&q, &in[0]));
+                        break;
+                case 1:
+                        assert(ref_q_dequeue(&ref, &a[0]) ==
+                               out_q_dequeue(&q, &b[0]));
+                        assert(same(&a[0], &b[0]));
+                        break;
+                case 2:
+                        assert(ref_q_enqueue_bulk(&ref, in, n, &na) ==
+                               out_q_enqueue_bulk(&q, in, n, &nb));
+                        assert(na == nb);
+                        break;
+                case 3:
+                        assert(ref_q_dequeue_bulk(&ref, a, n, &na) ==
+                               out_q_dequeue_bulk(&q, b, n, &nb));
+                        assert(na == nb);
+                        for (size_t i = 0; i < na; i++) {
+                                assert(same(&a[i], &b[i]));
+                        }
+                        break;
+                case 4: {
+                        elem_t *ra = ref_q_reserve(&ref);
+                        elem_t *rb = out_q_reserve(&q);
+                        assert((ra == NULL) == (rb == NULL));
+                        if (ra) {
+                                *ra = in[0];
+                                *rb = in[0];
+                                assert(ref_q_commit(&ref) == out_q_commit(&q));
+                        } else {
+                                assert(ref_q_commit(&ref) ==
+                                       QUEUE_STATUS_BAD_ARG);
+                                assert(out_q_commit(&q) ==
+                                       QUEUE_STATUS_BAD_ARG);
+                        }
+                        break;
+                }
+                case 5: {
+                        elem_t *ra = ref_q_reserve_span(&ref, &na);
+                        elem_t *rb = out_q_reserve_span(&q, &nb);
+                        assert(na == nb && ((ra == NULL) == (rb == NULL)));
+                        const size_t k = (n < na) ? n : na;
+                        if (k != 0U) {
+                                memcpy(ra, in, k * sizeof(elem_t));
+                                memcpy(rb, in, k * sizeof(elem_t));
+                                assert(ref_q_commit_n(&ref, k) ==
+                                       out_q_commit_n(&q, k));
+                        }
+                        break;
+                }
+                case 6: {
+                        elem_t *ra = ref_q_peek(&ref);
+                        elem_t *rb = out_q_peek(&q);
+                        assert((ra == NULL) == (rb == NULL));
+                        if (ra) {
+                                assert(same(ra, rb));
+                        }
+                        assert(ref_q_release(&ref) == out_q_release(&q));
+                        break;
+                }
+                case 7: {
+                        sink_t sa = {.n = 0U}, sb = {.n = 0U};
+                        assert(ref_q_consume(&ref, n, collect, &sa) ==
+                               out_q_consume(&q, n, collect, &sb));
+                        assert(sa.n == sb.n);
+                        for (size_t i = 0; i < sa.n; i++) {
+                                assert(same(&sa.items[i], &sb.items[i]));
+                        }
+                        break;
+                }
+                default:
+                        if (next_rand() % 16U == 0U) {
+                                ref_q_clear(&ref);
+                                QUEUE_CLEAR(out_q, &q);
+                        }
+                        break;
+                }
+                assert(ref_q_count(&ref) == out_q_count(&q));
+                assert(ref_q_is_full(&ref) == out_q_is_full(&q));
+                assert(ref_q_is_empty(&ref) == out_q_is_empty(&q));
+        }
+
+        printf("All outline tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,107 @@
+#define _POSIX_C_SOURCE 200809L
+#include "queue_pool.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MT_COUNT 200000U
+#define FRAME_WORDS 1024U
+
+typedef struct {
+        uint32_t seq;
+        uint32_t data[FRAME_WORDS];
+} frame_t;
+
+QUEUE_DEFINE_POOL(msg_pool, int, 3)
+QUEUE_DEFINE_POOL(frame_pool, frame_t, 8)
+
+static frame_pool_t fp;
+
+static void *
+producer(void *arg)
+{
+        (void)arg;
+        for (uint32_t i = 0U; i < MT_COUNT;) {
+                queue_handle_t h;
+                frame_t *f = frame_pool_alloc(&fp, &h);
+                if (!f) {
+                        sched_yield();
+                        continue;
+                }
+                f->seq = i;
+                for (uint32_t w = 0U; w < FRAME_WORDS; w++) {
+                        f->data[w] = i ^ w;
+                }
+                assert(frame_pool_send(&fp, h) == QUEUE_STATUS_OK);
+                i++;
+        }
+        return NULL;
+}
+
+int
+main(void)
+{
+        msg_pool_t p;
+        queue_handle_t h[4];
+        msg_pool_init(&p);
+        assert(msg_pool_blocks() == 3U && msg_pool_pending(&p) == 0U);
+        assert(msg_pool_block(&p, 3U) == NULL);
+        assert(msg_pool_send(&p, 3U) == QUEUE_STATUS_BAD_ARG);
+        assert(msg_pool_free(&p, 3U) == QUEUE_STATUS_BAD_ARG);
+        assert(msg_pool_receive(&p, &h[0]) == NULL);
+
+        /* Every block can be allocated once; the pool then runs dry. */
+        for (int i = 0; i < 3; i++) {
+                int *b = msg_pool_alloc(&p, &h[i]);
+                assert(b && (b == msg_pool_block(&p, h[i])));
+                *b = 100 + i;
+        }
+        assert(h[0] != h[1] && h[1] != h[2] && h[0] != h[2]);
+        assert(msg_pool_alloc(&p, &h[3]) == NULL);
+
+        /* Handles arrive in send order and point at the same blocks. */
+        assert(msg_pool_send(&p, h[1]) == QUEUE_STATUS_OK);
+        assert(msg_pool_send(&p, h[0]) == QUEUE_STATUS_OK);
+        assert(msg_pool_discard(&p, h[2]) == QUEUE_STATUS_OK);
+        assert(msg_pool_pending(&p) == 2U);
+        queue_handle_t r;
+        int *b = msg_pool_receive(&p, &r);
+        assert(b && r == h[1] && *b == 101);
+        assert(msg_pool_free(&p, r) == QUEUE_STATUS_OK);
+
+        /* Discarded blocks come back first, then freed ones. */
+        assert(msg_pool_alloc(&p, &h[3]) && h[3] == h[2]);
+        assert(msg_pool_alloc(&p, &h[3]) && h[3] == h[1]);
+        assert(msg_pool_alloc(&p, &h[3]) == NULL);
+        b = msg_pool_receive(&p, &r);
+        assert(b && r == h[0] && *b == 100);
+        assert(msg_pool_receive(&p, &r) == NULL);
+
+        /* Large frames change hands by handle across threads. */
+        frame_pool_init(&fp);
+        pthread_t th;
+        pthread_create(&th, NULL, producer, NULL);
+        for (uint32_t expected = 0U; expected < MT_COUNT;) {
+                queue_handle_t fh;
+                const frame_t *f = frame_pool_receive(&fp, &fh);
+                if (!f) {
+                        sched_yield();
+                        continue;
+                }
+                assert(f->seq == expected);
+                for (uint32_t w = 0U; w < FRAME_WORDS; w += 97U) {
+                        assert(f->data[w] == (expected ^ w));
+                }
+                assert(f->data[FRAME_WORDS - 1U] ==
+                       (expected ^ (FRAME_WORDS - 1U)));
+                assert(frame_pool_free(&fp, fh) == QUEUE_STATUS_OK);
+                expected++;
+        }
+        pthread_join(th, NULL);
+        assert(frame_pool_pending(&fp) == 0U);
+
+        printf("All pool tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,73 @@
+#include "queue.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+        uint32_t id;
+        uint8_t dlc;
+        uint8_t data[8];
+} can_msg_t;
+
+QUEUE_DEFINE_POW2(can_pow2_q, can_msg_t, 4)
+QUEUE_DEFINE_POW2(int_pow2_q, int, 8)
+
+int
+main(void)
+{
+        /* No sentinel slot: storage is exactly `capacity` elements. */
+        assert(sizeof(((can_pow2_q_t *)0)->buffer) == 4U * sizeof(can_msg_t));
+
+        can_pow2_q_t q = {0};
+        can_pow2_q_init(&q);
+        assert(can_pow2_q_capacity() == 4U);
+        assert(can_pow2_q_is_empty(&q));
+
+        can_msg_t out = {0};
+        assert(can_pow2_q_dequeue(&q, &out) == QUEUE_STATUS_EMPTY);
+        assert(can_pow2_q_dequeue(&q, NULL) == QUEUE_STATUS_BAD_ARG);
+        assert(can_pow2_q_enqueue(NULL, &out) == QUEUE_STATUS_BAD_ARG);
+
+        for (uint32_t i = 0; i < 4U; i++) {
+                can_msg_t m = {.id = i, .dlc = 8};
+                assert(can_pow2_q_enqueue(&q, &m) == QUEUE_STATUS_OK);
+        }
+        assert(can_pow2_q_is_full(&q));
+        assert(can_pow2_q_count(&q) == 4U);
+
+        can_msg_t m4 = {.id = 4U, .dlc = 8};
+#if QUEUE_OVERWRITE_ON_FULL
+        assert(can_pow2_q_enqueue(&q, &m4) == QUEUE_STATUS_OVERWROTE);
+        const uint32_t first = 1U;
+#else
+        assert(can_pow2_q_enqueue(&q, &m4) == QUEUE_STATUS_FULL);
+        const uint32_t first = 0U;
+#endif
+        assert(can_pow2_q_count(&q) == 4U);
+        for (uint32_t i = first; i < first + 4U; i++) {
+                assert(can_pow2_q_dequeue(&q, &out) == QUEUE_STATUS_OK);
+                assert(out.id == i);
+        }
+        assert(can_pow2_q_is_empty(&q));
+
+        /* Free-running counters wrap around SIZE_MAX transparently. */
+        int_pow2_q_t w;
+        int_pow2_q_init(&w);
+        queue__store_relaxed(&w.head, SIZE_MAX - 2U);
+        queue__store_relaxed(&w.tail, SIZE_MAX - 2U);
+        assert(int_pow2_q_is_empty(&w));
+        for (int i = 0; i < 8; i++) {
+                assert(int_pow2_q_enqueue(&w, &i) == QUEUE_STATUS_OK);
+                assert(int_pow2_q_count(&w) == (size_t)i + 1U);
+        }
+        assert(int_pow2_q_is_full(&w));
+        for (int i = 0; i < 8; i++) {
+                int v = -1;
+                assert(int_pow2_q_dequeue(&w, &v) == QUEUE_STATUS_OK);
+                assert(v == i);
+        }
+        assert(int_pow2_q_is_empty(&w));
+
+        printf("Power-of-two queue tests passed.\n");
+        return 0;
+}
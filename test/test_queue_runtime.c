@@ -0,0 +1,126 @@
+#include "queue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MT_COUNT 200000
+
+QUEUE_DEFINE_RUNTIME(rt_q, int)
+QUEUE_DEFINE_RUNTIME_PADDED(rt_pad_q, int)
+
+static int small_storage[QUEUE_RUNTIME_SLOTS(3)];
+
+static void
+check_small(rt_q_t *q, size_t capacity)
+{
+        assert(rt_q_capacity(q) == capacity);
+        for (int round = 0; round < 4; round++) {
+                int v;
+                for (size_t i = 0; i < capacity; i++) {
+                        v = (int)i;
+                        assert(rt_q_enqueue(q, &v) == QUEUE_STATUS_OK);
+                }
+                assert(rt_q_is_full(q));
+                assert(rt_q_count(q) == capacity);
+                v = 99;
+#if QUEUE_OVERWRITE_ON_FULL
+                assert(rt_q_enqueue(q, &v) == QUEUE_STATUS_OVERWROTE);
+                assert(rt_q_dequeue(q, &v) == QUEUE_STATUS_OK && v == 1);
+                for (size_t i = 2; i < capacity; i++) {
+                        assert(rt_q_dequeue(q, &v) == QUEUE_STATUS_OK);
+                        assert(v == (int)i);
+                }
+                assert(rt_q_dequeue(q, &v) == QUEUE_STATUS_OK && v == 99);
+#else
+                assert(rt_q_enqueue(q, &v) == QUEUE_STATUS_FULL);
+                for (size_t i = 0; i < capacity; i++) {
+                        assert(rt_q_dequeue(q, &v) == QUEUE_STATUS_OK);
+                        assert(v == (int)i);
+                }
+#endif
+                assert(rt_q_dequeue(q, &v) == QUEUE_STATUS_EMPTY);
+                assert(rt_q_is_empty(q));
+        }
+}
+
+#if !QUEUE_OVERWRITE_ON_FULL
+static void *
+producer(void *arg)
+{
+        rt_pad_q_t *q = (rt_pad_q_t *)arg;
+        for (int i = 0; i < MT_COUNT; i++) {
+                while (rt_pad_q_enqueue(q, &i) == QUEUE_STATUS_FULL) {
+                        // spin
+                }
+        }
+        return NULL;
+}
+#endif
+
+int
+main(void)
+{
+        rt_q_t q;
+        assert(rt_q_init(NULL, small_storage, 4U) == QUEUE_STATUS_BAD_ARG);
+        assert(rt_q_init(&q, NULL, 4U) == QUEUE_STATUS_BAD_ARG);
+        assert(rt_q_init(&q, small_storage, 1U) == QUEUE_STATUS_BAD_ARG);
+        assert(rt_q_capacity(NULL) == 0U);
+
+        /* Static storage. */
+        assert(rt_q_init(&q, small_storage, QUEUE_RUNTIME_SLOTS(3)) ==
+               QUEUE_STATUS_OK);
+        assert(rt_q_release(&q) == QUEUE_STATUS_EMPTY);
+        check_small(&q, 3U);
+
+        /* One-time allocation, size picked at run time; same functions. */
+        const size_t capacity = 5U + (size_t)(rand() % 4);
+        int *heap = malloc(QUEUE_RUNTIME_SLOTS(capacity) * sizeof(int));
+        assert(heap != NULL);
+        assert(rt_q_init(&q, heap, QUEUE_RUNTIME_SLOTS(capacity)) ==
+               QUEUE_STATUS_OK);
+        check_small(&q, capacity);
+
+        /* Bulk and zero-copy across the wrap point. */
+        int in[4] = {10, 11, 12, 13};
+        int out[4];
+        size_t n;
+        int v = 0;
+        for (size_t i = 0; i < capacity - 2U; i++) {
+                assert(rt_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+                assert(rt_q_dequeue(&q, &v) == QUEUE_STATUS_OK);
+        }
+        assert(rt_q_enqueue_bulk(&q, in, 4U, &n) == QUEUE_STATUS_OK);
+        assert(n == 4U && rt_q_count(&q) == 4U);
+        assert(*rt_q_peek(&q) == 10);
+        assert(rt_q_release(&q) == QUEUE_STATUS_OK);
+        assert(rt_q_dequeue_bulk(&q, out, 4U, &n) == QUEUE_STATUS_OK);
+        assert(n == 3U && out[0] == 11 && out[2] == 13);
+        int *slot = rt_q_reserve(&q);
+        assert(slot != NULL);
+        *slot = 42;
+        assert(rt_q_commit(&q) == QUEUE_STATUS_OK);
+        assert(rt_q_dequeue(&q, &v) == QUEUE_STATUS_OK && v == 42);
+        free(heap);
+
+#if !QUEUE_OVERWRITE_ON_FULL
+        /* Padded variant across threads. */
+        static int storage[QUEUE_RUNTIME_SLOTS(1024)];
+        static rt_pad_q_t pq;
+        assert(rt_pad_q_init(&pq, storage, QUEUE_RUNTIME_SLOTS(1024)) ==
+               QUEUE_STATUS_OK);
+        pthread_t th;
+        pthread_create(&th, NULL, producer, &pq);
+        for (int expected = 0; expected < MT_COUNT;) {
+                if (rt_pad_q_dequeue(&pq, &v) == QUEUE_STATUS_OK) {
+                        assert(v == expected);
+                        expected++;
+                }
+        }
+        pthread_join(th, NULL);
+        assert(rt_pad_q_is_empty(&pq));
+#endif
+
+        printf("All runtime queue tests passed.\n");
+        return 0;
+}
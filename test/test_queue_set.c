@@ -0,0 +1,141 @@
+#define _GNU_SOURCE
+#define QUEUE_OVERWRITE_ON_FULL 0
+#define QUEUE_ENABLE_SET        1
+#ifndef QUEUE_ENABLE_WAIT
+#define QUEUE_ENABLE_WAIT 1
+#endif
+#include "queue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define MEMBERS  40U
+#define MT_COUNT 400000U
+
+QUEUE_DEFINE(ch_q, unsigned, 16)
+QUEUE_DEFINE_RUNTIME(rt_q, unsigned)
+
+static queue_set_t set;
+static ch_q_t ch[MEMBERS];
+
+#if QUEUE_ENABLE_WAIT
+static void *
+producer(void *arg)
+{
+        (void)arg;
+        unsigned x = 7U;
+        for (unsigned i = 0U; i < MT_COUNT; i++) {
+                x = (x * 1103515245U) + 12345U;
+                ch_q_t *q = &ch[(x >> 16) % MEMBERS];
+                while (ch_q_enqueue(q, &i) == QUEUE_STATUS_FULL) {
+                        sched_yield();
+                }
+                if ((i % 1024U) == 0U) {
+                        sched_yield();
+                }
+        }
+        return NULL;
+}
+#endif
+
+int
+main(void)
+{
+        unsigned v = 0U;
+        queue_set_init(&set);
+        assert(queue_set_ready(&set) == 0U);
+        for (unsigned m = 0U; m < MEMBERS; m++) {
+                ch_q_init(&ch[m]);
+                assert(ch_q_set_attach(&ch[m], &set, m) == QUEUE_STATUS_OK);
+        }
+        assert(ch_q_set_attach(&ch[0], &set, QUEUE_SET_MEMBERS) ==
+               QUEUE_STATUS_BAD_ARG);
+        assert(queue_set_ready(&set) == 0U);
+
+        /* Publishing marks the member; ready members pop lowest first. */
+        v = 1U;
+        assert(ch_q_enqueue(&ch[37], &v) == QUEUE_STATUS_OK);
+        v = 2U;
+        assert(ch_q_enqueue(&ch[5], &v) == QUEUE_STATUS_OK);
+        assert(ch_q_enqueue(&ch[5], &v) == QUEUE_STATUS_OK);
+        uint64_t ready = queue_set_ready(&set);
+        assert(ready == ((UINT64_C(1) << 37) | (UINT64_C(1) << 5)));
+        assert(queue_set_pop(&ready) == 5U);
+        assert(queue_set_pop(&ready) == 37U);
+        assert(ready == 0U);
+
+        /* The bit stays set until the consumer finds the member empty. */
+        assert(ch_q_set_dequeue(&ch[5], &v) == QUEUE_STATUS_OK);
+        assert(ch_q_set_dequeue(&ch[5], &v) == QUEUE_STATUS_OK);
+        assert((queue_set_ready(&set) >> 5) & 1U);
+        assert(ch_q_set_dequeue(&ch[5], &v) == QUEUE_STATUS_EMPTY);
+        assert(queue_set_ready(&set) == (UINT64_C(1) << 37));
+
+        /* Bulk, zero-copy and batched publication mark it too. */
+        assert(ch_q_set_dequeue(&ch[37], &v) == QUEUE_STATUS_OK);
+        assert(!ch_q_set_rearm(&ch[37]) && queue_set_ready(&set) == 0U);
+        size_t n;
+        const unsigned items[3] = {1U, 2U, 3U};
+        assert(ch_q_enqueue_bulk(&ch[1], items, 3U, &n) == QUEUE_STATUS_OK);
+        *ch_q_reserve(&ch[2]) = 4U;
+        assert(ch_q_commit(&ch[2]) == QUEUE_STATUS_OK);
+        ch_q_producer_t p;
+        assert(ch_q_producer_init(&p, &ch[3], 8U) == QUEUE_STATUS_OK);
+        assert(ch_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        assert(queue_set_ready(&set) == 0x6U);
+        assert(ch_q_flush(&p) == QUEUE_STATUS_OK);
+        assert(queue_set_ready(&set) == 0xEU);
+        unsigned out[4];
+        for (unsigned m = 1U; m <= 3U; m++) {
+                assert(ch_q_dequeue_bulk(&ch[m], out, 4U, &n) ==
+                       QUEUE_STATUS_OK);
+                assert(!ch_q_set_rearm(&ch[m]));
+        }
+        assert(queue_set_ready(&set) == 0U);
+
+        /* Attaching a non-empty queue marks it; detaching clears it. */
+        static unsigned storage[QUEUE_RUNTIME_SLOTS(4)];
+        rt_q_t rq;
+        assert(rt_q_init(&rq, storage, QUEUE_RUNTIME_SLOTS(4)) ==
+               QUEUE_STATUS_OK);
+        assert(rt_q_enqueue(&rq, &v) == QUEUE_STATUS_OK);
+        assert(rt_q_set_attach(&rq, &set, 63U) == QUEUE_STATUS_OK);
+        assert(queue_set_ready(&set) == (UINT64_C(1) << 63));
+        rt_q_set_detach(&rq);
+        assert(queue_set_ready(&set) == 0U);
+        assert(rt_q_enqueue(&rq, &v) == QUEUE_STATUS_OK);
+        assert(queue_set_ready(&set) == 0U);
+
+#if QUEUE_ENABLE_WAIT
+        assert(queue_set_wait(&set, 0) == 0U);
+        assert(queue_set_wait(&set, 1000000) == 0U);
+
+        /* One producer spread over 40 queues, consumer sleeps on the set. */
+        pthread_t th;
+        pthread_create(&th, NULL, producer, NULL);
+        unsigned last[MEMBERS];
+        bool seen[MEMBERS] = {false};
+        unsigned got = 0U;
+        while (got < MT_COUNT) {
+                ready = queue_set_wait(&set, -1);
+                while (ready != 0U) {
+                        const unsigned m = queue_set_pop(&ready);
+                        while (ch_q_set_dequeue(&ch[m], &v) ==
+                               QUEUE_STATUS_OK) {
+                                assert(!seen[m] || (v > last[m]));
+                                seen[m] = true;
+                                last[m] = v;
+                                got++;
+                        }
+                }
+        }
+        pthread_join(th, NULL);
+        for (unsigned m = 0U; m < MEMBERS; m++) {
+                assert(ch_q_is_empty(&ch[m]));
+        }
+#endif
+
+        printf("All queue set tests passed.\n");
+        return 0;
+}
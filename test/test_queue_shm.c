@@ -0,0 +1,109 @@
+#define _DEFAULT_SOURCE
+#define QUEUE_OVERWRITE_ON_FULL 0
+#include "queue_shm.h"
+#include <assert.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/wait.h>
+
+#define ITEMS 200000U
+
+typedef struct {
+        uint32_t seq;
+        uint32_t check;
+} msg_t;
+
+QUEUE_DEFINE_SHM(msg_q, msg_t, 256)
+QUEUE_DEFINE_SHM(small_q, msg_t, 128)
+QUEUE_DEFINE_SHM(wide_q, uint64_t, 256)
+
+static int
+consume(const char *path)
+{
+        msg_q_t *q = NULL;
+        if (msg_q_shm_attach(path, &q) != QUEUE_STATUS_OK) {
+                return 1;
+        }
+        for (uint32_t i = 0U; i < ITEMS; i++) {
+                msg_t m;
+                while (msg_q_dequeue(q, &m) != QUEUE_STATUS_OK) {
+                        sched_yield();
+                }
+                if ((m.seq != i) || (m.check != ~i)) {
+                        return 2;
+                }
+        }
+        msg_q_shm_detach(q);
+        return 0;
+}
+
+int
+main(void)
+{
+        char path[64];
+        (void)snprintf(path, sizeof(path), "/queue_test_shm_%ld",
+                       (long)getpid());
+        (void)shm_unlink(path);
+
+        msg_q_t *q = NULL;
+        assert(msg_q_shm_attach(path, &q) == QUEUE_STATUS_SYS_ERROR);
+        assert(errno == ENOENT);
+        assert(msg_q_shm_create(NULL, &q) == QUEUE_STATUS_BAD_ARG);
+        assert(msg_q_shm_create(path, &q) == QUEUE_STATUS_OK);
+        assert(msg_q_shm_create(path, &q) == QUEUE_STATUS_SYS_ERROR);
+        assert(errno == EEXIST);
+
+        /* Header describes the layout; incompatible attachers are refused. */
+        const size_t offset = msg_q_shm_size() - sizeof(msg_q_t);
+        const queue_shm_header_t *hdr =
+            (const queue_shm_header_t *)(const void *)((char *)q - offset);
+        assert(hdr->queue_offset == offset);
+        assert(atomic_load(&hdr->magic) == QUEUE_SHM_MAGIC);
+        assert(hdr->queue_capacity == 256U && hdr->elem_size == sizeof(msg_t));
+        assert(hdr->flags & QUEUE_SHM_FLAG_PADDED);
+        assert(((hdr->flags & QUEUE_SHM_FLAG_SET) != 0U) == QUEUE_ENABLE_SET);
+        assert(((hdr->flags & QUEUE_SHM_FLAG_TRACE) != 0U) ==
+               QUEUE_ENABLE_TRACE);
+#if QUEUE_ENABLE_SET
+        assert(q->set == NULL);
+#endif
+        small_q_t *small = NULL;
+        assert(small_q_shm_attach(path, &small) == QUEUE_STATUS_MISMATCH);
+        wide_q_t *wide = NULL;
+        assert(wide_q_shm_attach(path, &wide) == QUEUE_STATUS_MISMATCH);
+
+        /* A second mapping lands at another address and sees the same ring. */
+        msg_q_t *view = NULL;
+        assert(msg_q_shm_attach(path, &view) == QUEUE_STATUS_OK);
+        assert(view != q);
+        msg_t m = {7U, ~7U};
+        assert(msg_q_enqueue(q, &m) == QUEUE_STATUS_OK);
+        assert(msg_q_count(view) == 1U);
+        assert(msg_q_dequeue(view, &m) == QUEUE_STATUS_OK && m.seq == 7U);
+        assert(msg_q_is_empty(q));
+        msg_q_shm_detach(view);
+
+        /* Producer here, consumer in a child process. */
+        const pid_t pid = fork();
+        assert(pid >= 0);
+        if (pid == 0) {
+                _exit(consume(path));
+        }
+        for (uint32_t i = 0U; i < ITEMS; i++) {
+                m.seq = i;
+                m.check = ~i;
+                while (msg_q_enqueue(q, &m) == QUEUE_STATUS_FULL) {
+                        sched_yield();
+                }
+        }
+        int status = 0;
+        assert(waitpid(pid, &status, 0) == pid);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        assert(msg_q_is_empty(q));
+
+        msg_q_shm_detach(q);
+        assert(shm_unlink(path) == 0);
+
+        printf("All shm queue tests passed.\n");
+        return 0;
+}
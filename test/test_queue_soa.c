@@ -0,0 +1,135 @@
+#define _POSIX_C_SOURCE 200809L
+#include "queue_soa.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MT_COUNT 2000000U
+
+#define SAMPLE_FIELDS(X, ctx)                                                  \
+        X(ctx, float, value)                                                   \
+        X(ctx, uint32_t, seq)                                                  \
+        X(ctx, uint8_t, channel)
+
+QUEUE_DEFINE_SOA(sample_q, 6, SAMPLE_FIELDS)
+QUEUE_DEFINE_SOA(mt_sample_q, 256, SAMPLE_FIELDS)
+
+static mt_sample_q_t mq;
+
+static void *
+producer(void *arg)
+{
+        (void)arg;
+        for (uint32_t next = 0U; next < MT_COUNT;) {
+                mt_sample_q_span_t span;
+                size_t n = mt_sample_q_reserve_span(&mq, &span);
+                if (n == 0U) {
+                        sched_yield();
+                        continue;
+                }
+                if (n > MT_COUNT - next) {
+                        n = MT_COUNT - next;
+                }
+                for (size_t i = 0U; i < n; i++) {
+                        span.value[i] = (float)(next + i);
+                        span.seq[i] = next + (uint32_t)i;
+                        span.channel[i] = (uint8_t)(next + i);
+                }
+                assert(mt_sample_q_commit_n(&mq, n) == QUEUE_STATUS_OK);
+                next += (uint32_t)n;
+        }
+        return NULL;
+}
+
+int
+main(void)
+{
+        sample_q_t q;
+        sample_q_init(&q);
+        assert(sample_q_capacity() == 6U && sample_q_is_empty(&q));
+        assert(((uintptr_t)q.value % QUEUE_CACHE_LINE_SIZE) == 0U);
+        assert(((uintptr_t)q.seq % QUEUE_CACHE_LINE_SIZE) == 0U);
+
+        /* Per-element calls scatter and gather the fields. */
+        sample_q_item_t it = {1.5f, 7U, 3U};
+        assert(sample_q_enqueue(&q, &it) == QUEUE_STATUS_OK);
+        assert(q.value[0] == 1.5f && q.seq[0] == 7U && q.channel[0] == 3U);
+        sample_q_item_t out;
+        assert(sample_q_dequeue(&q, &out) == QUEUE_STATUS_OK);
+        assert(out.value == 1.5f && out.seq == 7U && out.channel == 3U);
+        assert(sample_q_dequeue(&q, &out) == QUEUE_STATUS_EMPTY);
+
+        /* Fill to capacity across the wrap point. */
+        for (uint32_t i = 0U; i < 6U; i++) {
+                it.value = (float)i;
+                it.seq = i;
+                assert(sample_q_enqueue(&q, &it) == QUEUE_STATUS_OK);
+        }
+        assert(sample_q_is_full(&q));
+        assert(sample_q_enqueue(&q, &it) == QUEUE_STATUS_FULL);
+
+        /* Spans stop at the wrap; each field is contiguous. */
+        sample_q_span_t span;
+        size_t n = sample_q_peek_span(&q, &span);
+        assert(n == 6U);
+        float sum = 0.0f;
+        for (size_t i = 0U; i < n; i++) {
+                sum += span.value[i];
+                assert(span.seq[i] == (uint32_t)i);
+        }
+        assert(sum == 15.0f);
+        assert(sample_q_release_n(&q, 4U) == QUEUE_STATUS_OK);
+        for (uint32_t i = 6U; i < 9U; i++) {
+                it.seq = i;
+                assert(sample_q_enqueue(&q, &it) == QUEUE_STATUS_OK);
+        }
+        n = sample_q_peek_span(&q, &span);
+        assert(n == 2U && span.seq[0] == 4U && span.seq[1] == 5U);
+        assert(sample_q_release_n(&q, n) == QUEUE_STATUS_OK);
+        n = sample_q_peek_span(&q, &span);
+        assert(n == 3U && span.seq[0] == 6U && span.seq[2] == 8U);
+        assert(sample_q_release_n(&q, n) == QUEUE_STATUS_OK);
+        assert(sample_q_peek_span(&q, &span) == 0U);
+
+        assert(sample_q_release_n(&q, 1U) == QUEUE_STATUS_BAD_ARG);
+
+        n = sample_q_reserve_span(&q, &span);
+        assert(n == 4U && span.seq == &q.seq[3]);
+        /* Free space (not just the span) bounds a commit. */
+        assert(sample_q_commit_n(&q, 7U) == QUEUE_STATUS_BAD_ARG);
+        assert(sample_q_is_empty(&q));
+        assert(sample_q_commit_n(&q, 6U) == QUEUE_STATUS_OK);
+        assert(sample_q_is_full(&q));
+        assert(sample_q_commit_n(&q, 1U) == QUEUE_STATUS_BAD_ARG);
+        assert(sample_q_release_n(&q, 7U) == QUEUE_STATUS_BAD_ARG);
+        assert(sample_q_release_n(&q, 6U) == QUEUE_STATUS_OK);
+        assert(sample_q_is_empty(&q));
+
+        /* Span producer and span consumer on separate threads. */
+        mt_sample_q_init(&mq);
+        pthread_t th;
+        pthread_create(&th, NULL, producer, NULL);
+        uint32_t expected = 0U;
+        while (expected < MT_COUNT) {
+                mt_sample_q_span_t rs;
+                n = mt_sample_q_peek_span(&mq, &rs);
+                if (n == 0U) {
+                        sched_yield();
+                        continue;
+                }
+                for (size_t i = 0U; i < n; i++) {
+                        assert(rs.seq[i] == expected + i);
+                        assert(rs.channel[i] == (uint8_t)(expected + i));
+                }
+                assert(rs.value[n - 1U] == (float)(expected + n - 1U));
+                assert(mt_sample_q_release_n(&mq, n) == QUEUE_STATUS_OK);
+                expected += (uint32_t)n;
+        }
+        pthread_join(th, NULL);
+        assert(mt_sample_q_is_empty(&mq));
+
+        printf("All SoA queue tests passed.\n");
+        return 0;
+}
@@ -0,0 +1,86 @@
+#define QUEUE_ENABLE_STATS 1
+#include "queue.h"
+#include <assert.h>
+#include <stdio.h>
+
+typedef int elem_t;
+QUEUE_DEFINE(stats_q, elem_t, 4)
+QUEUE_DEFINE_PADDED(stats_pad_q, elem_t, 4)
+QUEUE_DEFINE_POW2(stats_pow2_q, elem_t, 4)
+
+int
+main(void)
+{
+        stats_q_t q;
+        stats_q_init(&q);
+
+        queue_stats_t st;
+        stats_q_stats(&q, &st);
+        assert(st.enqueued == 0U && st.dequeued == 0U);
+        assert(st.high_watermark == 0U);
+
+        elem_t v = 1;
+        for (int i = 0; i < 3; i++) {
+                assert(stats_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+        }
+        assert(stats_q_dequeue(&q, &v) == QUEUE_STATUS_OK);
+        stats_q_stats(&q, &st);
+        assert(st.enqueued == 3U && st.dequeued == 1U);
+        assert(st.high_watermark == 3U);
+
+        /* 2 queued: fill to 4, then one more. */
+        elem_t in[3] = {7, 8, 9};
+        size_t n = 0U;
+#if QUEUE_OVERWRITE_ON_FULL
+        assert(stats_q_enqueue_bulk(&q, in, 3U, &n) == QUEUE_STATUS_OVERWROTE);
+        stats_q_stats(&q, &st);
+        assert(st.enqueued == 6U && st.overwritten == 1U && st.full == 0U);
+        assert(stats_q_enqueue(&q, &v) == QUEUE_STATUS_OVERWROTE);
+        stats_q_stats(&q, &st);
+        assert(st.enqueued == 7U && st.overwritten == 2U);
+#else
+        assert(stats_q_enqueue_bulk(&q, in, 3U, &n) == QUEUE_STATUS_FULL);
+        stats_q_stats(&q, &st);
+        assert(st.enqueued == 5U && st.full == 1U && st.overwritten == 0U);
+        assert(stats_q_enqueue(&q, &v) == QUEUE_STATUS_FULL);
+        stats_q_stats(&q, &st);
+        assert(st.enqueued == 5U && st.full == 2U);
+#endif
+        assert(st.high_watermark == 4U);
+
+        elem_t out[4];
+        assert(stats_q_dequeue_bulk(&q, out, 4U, &n) == QUEUE_STATUS_OK);
+        assert(stats_q_reserve(&q) != NULL);
+        assert(stats_q_commit(&q) == QUEUE_STATUS_OK);
+        assert(stats_q_peek(&q) != NULL);
+        assert(stats_q_release(&q) == QUEUE_STATUS_OK);
+        stats_q_stats(&q, &st);
+        assert(st.dequeued == 1U + 4U + 1U);
+        assert(st.enqueued == st.dequeued + st.overwritten);
+
+        stats_q_stats_reset(&q);
+        stats_q_stats(&q, &st);
+        assert(st.enqueued == 0U && st.dequeued == 0U && st.full == 0U);
+        assert(st.overwritten == 0U && st.high_watermark == 0U);
+
+        /* Padded and power-of-two queues carry the same counters. */
+        stats_pad_q_t p;
+        stats_pad_q_init(&p);
+        assert(stats_pad_q_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        assert(stats_pad_q_dequeue(&p, &v) == QUEUE_STATUS_OK);
+        stats_pad_q_stats(&p, &st);
+        assert(st.enqueued == 1U && st.dequeued == 1U);
+        assert(st.high_watermark == 1U);
+
+        stats_pow2_q_t w;
+        stats_pow2_q_init(&w);
+        for (int i = 0; i < 5; i++) {
+                (void)stats_pow2_q_enqueue(&w, &v);
+        }
+        stats_pow2_q_stats(&w, &st);
+        assert(st.high_watermark == 4U);
+        assert(st.overwritten + st.full == 1U);
+
+        printf("Queue statistics tests passed.\n");
+        return 0;
+}
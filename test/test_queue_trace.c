@@ -0,0 +1,93 @@
+#include <stdint.h>
+
+static uint64_t fake_now;
+#define QUEUE_TRACE_CLOCK() fake_now
+#define QUEUE_ENABLE_TRACE  1
+#include "queue.h"
+#include <assert.h>
+#include <stdio.h>
+
+QUEUE_DEFINE(trace_q, int, 8)
+QUEUE_DEFINE_PADDED(trace_pad_q, int, 1024)
+
+/* Upper bound reported for `v` must cover it within one sub-bucket. */
+static void
+check_bound(uint64_t v, uint64_t reported)
+{
+        assert(reported >= v);
+        assert(reported - v <= (v >> QUEUE_TRACE_SUB_BITS));
+}
+
+int
+main(void)
+{
+        trace_q_t q;
+        trace_q_init(&q);
+        assert(trace_q_trace_count(&q) == 0U);
+        assert(trace_q_trace_percentile(&q, 50.0) == 0U);
+        assert(trace_q_trace_count(NULL) == 0U);
+
+        /* Small deltas are exact. */
+        int v = 1;
+        fake_now = 1000U;
+        assert(trace_q_enqueue(&q, &v) == QUEUE_STATUS_OK);
+        fake_now += 5U;
+        assert(trace_q_dequeue(&q, &v) == QUEUE_STATUS_OK);
+        assert(trace_q_trace_count(&q) == 1U);
+        assert(trace_q_trace_percentile(&q, 50.0) == 5U);
+        assert(trace_q_trace_percentile(&q, 100.0) == 5U);
+
+        /* Bulk, zero-copy and batched paths stamp and record per item. */
+        int in[4] = {0, 1, 2, 3}, out[4];
+        size_t n;
+        trace_q_trace_reset(&q);
+        assert(trace_q_enqueue_bulk(&q, in, 4U, &n) == QUEUE_STATUS_OK);
+        fake_now += 3U;
+        assert(trace_q_dequeue_bulk(&q, out, 4U, &n) == QUEUE_STATUS_OK);
+        assert(n == 4U && trace_q_trace_count(&q) == 4U);
+        assert(trace_q_trace_percentile(&q, 0.0) == 3U);
+
+        int *slot = trace_q_reserve(&q);
+        assert(slot != NULL);
+        *slot = 7;
+        assert(trace_q_commit(&q) == QUEUE_STATUS_OK);
+        fake_now += 6U;
+        assert(trace_q_peek(&q) != NULL);
+        assert(trace_q_release(&q) == QUEUE_STATUS_OK);
+
+        trace_q_producer_t p;
+        assert(trace_q_producer_init(&p, &q, 2U) == QUEUE_STATUS_OK);
+        assert(trace_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        fake_now += 1U;
+        assert(trace_q_producer_enqueue(&p, &v) == QUEUE_STATUS_OK);
+        fake_now += 1U;
+        assert(trace_q_dequeue(&q, &v) == QUEUE_STATUS_OK);
+        assert(trace_q_dequeue(&q, &v) == QUEUE_STATUS_OK);
+        assert(trace_q_trace_count(&q) == 7U);
+        assert(trace_q_trace_percentile(&q, 100.0) == 6U);
+        assert(trace_q_trace_percentile(&q, 1.0) == 1U);
+
+        /* Uniform 1..1000 delay: percentiles within the bucket error. */
+        trace_pad_q_t pq;
+        trace_pad_q_init(&pq);
+        for (uint64_t d = 1U; d <= 1000U; d++) {
+                fake_now = 0U;
+                assert(trace_pad_q_enqueue(&pq, &v) == QUEUE_STATUS_OK);
+                fake_now = d;
+                assert(trace_pad_q_dequeue(&pq, &v) == QUEUE_STATUS_OK);
+        }
+        assert(trace_pad_q_trace_count(&pq) == 1000U);
+        check_bound(500U, trace_pad_q_trace_percentile(&pq, 50.0));
+        check_bound(990U, trace_pad_q_trace_percentile(&pq, 99.0));
+        check_bound(1000U, trace_pad_q_trace_percentile(&pq, 100.0));
+
+        /* Large deltas stay in range. */
+        fake_now = 0U;
+        assert(trace_pad_q_enqueue(&pq, &v) == QUEUE_STATUS_OK);
+        fake_now = UINT64_MAX;
+        assert(trace_pad_q_dequeue(&pq, &v) == QUEUE_STATUS_OK);
+        assert(trace_pad_q_trace_percentile(&pq, 100.0) == UINT64_MAX);
+
+        printf("All trace tests passed.\n");
+        return 0;
+}
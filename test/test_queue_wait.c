@@ -0,0 +1,83 @@
+#define _GNU_SOURCE
+#define QUEUE_OVERWRITE_ON_FULL 0
+#define QUEUE_ENABLE_WAIT 1
+#include "queue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+
+#define ITEMS 200000U
+
+typedef unsigned elem_t;
+QUEUE_DEFINE(wait_q, elem_t, 8)
+QUEUE_DEFINE_PADDED(wait_pad_q, elem_t, 8)
+
+static wait_q_t q;
+static wait_pad_q_t pq;
+
+static void *
+producer(void *arg)
+{
+        (void)arg;
+        for (elem_t i = 0U; i < ITEMS; i++) {
+                assert(wait_q_enqueue_wait(&q, &i, -1) == QUEUE_STATUS_OK);
+        }
+        return NULL;
+}
+
+static void *
+pad_consumer(void *arg)
+{
+        (void)arg;
+        for (elem_t i = 0U; i < ITEMS; i++) {
+                elem_t v;
+                assert(wait_pad_q_dequeue_wait(&pq, &v, -1) ==
+                       QUEUE_STATUS_OK);
+                assert(v == i);
+        }
+        return NULL;
+}
+
+int
+main(void)
+{
+        elem_t v = 0U;
+
+        /* Timeouts: empty dequeue and full enqueue give up. */
+        wait_q_init(&q);
+        assert(wait_q_dequeue_wait(&q, &v, 0) == QUEUE_STATUS_EMPTY);
+        int64_t t0 = queue__now_ns();
+        assert(wait_q_dequeue_wait(&q, &v, 2000000) == QUEUE_STATUS_EMPTY);
+        assert(queue__now_ns() - t0 >= 2000000);
+        for (elem_t i = 0U; i < 8U; i++) {
+                assert(wait_q_enqueue_wait(&q, &i, 0) == QUEUE_STATUS_OK);
+        }
+        t0 = queue__now_ns();
+        assert(wait_q_enqueue_wait(&q, &v, 2000000) == QUEUE_STATUS_FULL);
+        assert(queue__now_ns() - t0 >= 2000000);
+        assert(wait_q_dequeue_wait(&q, &v, -1) == QUEUE_STATUS_OK && v == 0U);
+        assert(atomic_load(&q.wait_consumers) == 0U);
+        assert(atomic_load(&q.wait_producers) == 0U);
+
+        /* Blocking producer against a blocking consumer, both directions. */
+        wait_q_init(&q);
+        pthread_t th;
+        assert(pthread_create(&th, NULL, producer, NULL) == 0);
+        for (elem_t i = 0U; i < ITEMS; i++) {
+                assert(wait_q_dequeue_wait(&q, &v, -1) == QUEUE_STATUS_OK);
+                assert(v == i);
+        }
+        assert(pthread_join(th, NULL) == 0);
+
+        wait_pad_q_init(&pq);
+        assert(pthread_create(&th, NULL, pad_consumer, NULL) == 0);
+        for (elem_t i = 0U; i < ITEMS; i++) {
+                assert(wait_pad_q_enqueue_wait(&pq, &i, -1) ==
+                       QUEUE_STATUS_OK);
+        }
+        assert(pthread_join(th, NULL) == 0);
+        assert(wait_pad_q_is_empty(&pq));
+
+        printf("All wait tests passed.\n");
+        return 0;
+}
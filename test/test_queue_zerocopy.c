@@ -0,0 +1,127 @@
+#define QUEUE_OVERWRITE_ON_FULL 0
+#include "queue.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+        uint32_t seq;
+        uint8_t payload[60];
+} frame_t;
+
+#define MT_COUNT 1000000
+QUEUE_DEFINE(zc_q, frame_t, 4)
+QUEUE_DEFINE(span_q, int, 6)
+QUEUE_DEFINE_PADDED(zc_mt_q, frame_t, 256)
+
+void *
+producer(void *arg)
+{
+        zc_mt_q_t *q = (zc_mt_q_t *)arg;
+        for (uint32_t i = 0; i < MT_COUNT; i++) {
+                frame_t *f;
+                while ((f = zc_mt_q_reserve(q)) == NULL) {
+                        // spin
+                }
+                f->seq = i;
+                f->payload[59] = (uint8_t)i;
+                (void)zc_mt_q_commit(q);
+        }
+        return NULL;
+}
+
+void *
+consumer(void *arg)
+{
+        zc_mt_q_t *q = (zc_mt_q_t *)arg;
+        uint32_t expected = 0;
+        while (expected < MT_COUNT) {
+                const frame_t *f = zc_mt_q_peek(q);
+                if (f != NULL) {
+                        assert(f->seq == expected);
+                        assert(f->payload[59] == (uint8_t)expected);
+                        (void)zc_mt_q_release(q);
+                        expected++;
+                }
+        }
+        return NULL;
+}
+
+int
+main(void)
+{
+        zc_q_t q;
+        zc_q_init(&q);
+        assert(zc_q_reserve(NULL) == NULL);
+        assert(zc_q_peek(&q) == NULL);
+
+        /* Build in place, consume in place. */
+        for (uint32_t i = 0; i < 4U; i++) {
+                frame_t *f = zc_q_reserve(&q);
+                assert(f != NULL);
+                f->seq = i;
+                assert(zc_q_commit(&q) == QUEUE_STATUS_OK);
+        }
+        assert(zc_q_is_full(&q));
+        assert(zc_q_reserve(&q) == NULL);
+        for (uint32_t i = 0; i < 4U; i++) {
+                const frame_t *f = zc_q_peek(&q);
+                assert(f != NULL && f->seq == i);
+                /* peek does not consume */
+                assert(zc_q_peek(&q) == f);
+                assert(zc_q_release(&q) == QUEUE_STATUS_OK);
+        }
+        assert(zc_q_is_empty(&q));
+        /* Nothing to release: the indices must not move. */
+        assert(zc_q_release(&q) == QUEUE_STATUS_EMPTY);
+        assert(zc_q_is_empty(&q) && !zc_q_is_full(&q));
+
+        /* Contiguous spans stop at the wrap point. */
+        span_q_t s;
+        span_q_init(&s);
+        size_t len = 0U;
+        int *span = span_q_reserve_span(&s, &len);
+        assert(span == &s.buffer[0] && len == 6U);
+        for (int i = 0; i < 4; i++) {
+                span[i] = i;
+        }
+        assert(span_q_commit_n(&s, 4U) == QUEUE_STATUS_OK);
+        assert(span_q_count(&s) == 4U);
+        int v;
+        assert(span_q_dequeue(&s, &v) == QUEUE_STATUS_OK && v == 0);
+        assert(span_q_dequeue(&s, &v) == QUEUE_STATUS_OK && v == 1);
+
+        /* head=4, tail=2: three slots to the end of the ring. */
+        span = span_q_reserve_span(&s, &len);
+        assert(span == &s.buffer[4] && len == 3U);
+        for (int i = 0; i < 3; i++) {
+                span[i] = 4 + i;
+        }
+        assert(span_q_commit_n(&s, 3U) == QUEUE_STATUS_OK);
+
+        /* head=0, tail=2: one slot before the sentinel. */
+        span = span_q_reserve_span(&s, &len);
+        assert(span == &s.buffer[0] && len == 1U);
+        span[0] = 7;
+        assert(span_q_commit_n(&s, 1U) == QUEUE_STATUS_OK);
+        assert(span_q_is_full(&s));
+        assert(span_q_reserve_span(&s, &len) == NULL && len == 0U);
+        /* Committing more than the free space is refused. */
+        assert(span_q_commit_n(&s, 1U) == QUEUE_STATUS_BAD_ARG);
+        assert(span_q_is_full(&s));
+        for (int i = 2; i < 8; i++) {
+                assert(span_q_dequeue(&s, &v) == QUEUE_STATUS_OK && v == i);
+        }
+
+        static zc_mt_q_t mt;
+        zc_mt_q_init(&mt);
+        pthread_t prod_thread, cons_thread;
+        pthread_create(&prod_thread, NULL, producer, &mt);
+        pthread_create(&cons_thread, NULL, consumer, &mt);
+        pthread_join(prod_thread, NULL);
+        pthread_join(cons_thread, NULL);
+
+        printf("Zero-copy reserve/commit and peek/release tests passed.\n");
+        return 0;
+}